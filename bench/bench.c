@@ -0,0 +1,424 @@
+/**
+ * @file bench.c
+ * @brief Decoder benchmark over a deterministic synthetic corpus (see gif_corpus.h).
+ *
+ * One binary measures one build configuration; build it once per configuration and
+ * compare the results. Within a build, every engine the mode offers is measured:
+ * `safe` in Safe mode; `turbo`, `canvas` (index canvas), `frame_cache` (index canvas and
+ * looped-playback cache) and `parallel` (index canvas and segment-parallel decoding) in
+ * Turbo mode.
+ *
+ * Build (POSIX):
+ * @code
+ * cc -O2 -std=c99 -DGIF_MAX_WIDTH=1024 -o bench_safe bench/bench.c
+ * cc -O2 -std=c99 -DGIF_MAX_WIDTH=1024 -DGIF_MODE_TURBO -o bench_turbo bench/bench.c
+ * cc -O2 -std=c99 -DGIF_MAX_WIDTH=1024 -DGIF_MODE_TURBO -DGIF_NO_LZW_SPECIALIZATION -o bench_turbo_generic bench/bench.c
+ * cc -O2 -std=c99 -DGIF_MAX_WIDTH=1024 -DGIF_MODE_TURBO -DBENCH_PTHREADS -pthread -o bench_turbo_mt bench/bench.c
+ * @endcode
+ *
+ * Usage: `bench [-o results.jsonl] [-r runs] [-t min_seconds] [-s scale_percent] [-c case] [file.gif ...]`
+ *
+ * Every run of every case and engine is written as one JSON line with the compressed
+ * input throughput (MB/s), the output throughput (Mpixels/s) and per-frame latency
+ * percentiles. GIF files given on the command line are measured after the corpus
+ * (class `file`).
+ */
+#define _POSIX_C_SOURCE 199309L
+#define GIF_IMPLEMENTATION
+#include "../gif.h"
+#include "gif_corpus.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef BENCH_PTHREADS
+#include <pthread.h>
+#endif
+
+/** @brief Number of workers of the `parallel` engine. */
+#ifndef BENCH_WORKERS
+#define BENCH_WORKERS 4
+#endif
+
+/** @brief Build configuration reported in the results. */
+#ifdef GIF_MODE_TURBO
+#define BENCH_MODE "turbo"
+#else
+#define BENCH_MODE "safe"
+#endif
+#ifdef GIF_NO_LZW_SPECIALIZATION
+#define BENCH_SPECIALIZED 0
+#else
+#define BENCH_SPECIALIZED 1
+#endif
+
+/** @brief Engines of the build. */
+enum {
+#ifdef GIF_MODE_TURBO
+    BENCH_TURBO,
+    BENCH_CANVAS,
+    BENCH_FRAME_CACHE,
+    BENCH_PARALLEL,
+#else
+    BENCH_SAFE,
+#endif
+    BENCH_ENGINE_COUNT
+};
+
+/** @brief Names of the engines, in enum order. */
+static const char *const bench_engine_names[] = {
+#ifdef GIF_MODE_TURBO
+    "turbo", "canvas", "frame_cache", "parallel"
+#else
+    "safe"
+#endif
+};
+
+/** @brief One GIF to measure. */
+typedef struct {
+    /** @brief Name of the case. */
+    const char *name;
+    /** @brief Class of the case. */
+    const char *class_name;
+    /** @brief GIF data. */
+    uint8_t *data;
+    /** @brief Size of the GIF data. */
+    size_t size;
+} BenchInput;
+
+/** @brief Options of the run. */
+typedef struct {
+    /** @brief Runs per case and engine. */
+    int runs;
+    /** @brief Minimum measured time per run, in seconds. */
+    double min_seconds;
+    /** @brief Corpus scale in percent. */
+    int scale;
+    /** @brief Only measure the case with this name, if set. */
+    const char *only_case;
+} BenchOptions;
+
+/** @brief Growable array of per-frame latencies. */
+typedef struct {
+    /** @brief Latencies in nanoseconds. */
+    uint64_t *values;
+    /** @brief Number of latencies. */
+    size_t count;
+    /** @brief Allocated entries. */
+    size_t capacity;
+} BenchSamples;
+
+/**
+ * @brief Returns a monotonic timestamp.
+ * @return Nanoseconds since an arbitrary origin.
+ */
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Appends a latency sample.
+ * @param s Sample array.
+ * @param value Latency in nanoseconds.
+ * @return 1 on success, 0 if out of memory.
+ */
+static int bench_add_sample(BenchSamples *s, uint64_t value) {
+    if (s->count == s->capacity) {
+        size_t capacity = s->capacity ? s->capacity * 2 : 1024;
+        uint64_t *grown = (uint64_t*)realloc(s->values, capacity * sizeof(uint64_t));
+        if (!grown) {
+            return 0;
+        }
+        s->values = grown;
+        s->capacity = capacity;
+    }
+    s->values[s->count++] = value;
+    return 1;
+}
+
+/**
+ * @brief qsort() comparator for latencies.
+ */
+static int bench_compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * @brief Returns a percentile of sorted latencies (nearest rank).
+ * @param s Sorted samples.
+ * @param percent Percentile (0 to 100).
+ * @return Latency in microseconds.
+ */
+static double bench_percentile_us(const BenchSamples *s, double percent) {
+    size_t rank;
+    if (s->count == 0) {
+        return 0.0;
+    }
+    rank = (size_t)(percent / 100.0 * (double)(s->count - 1) + 0.5);
+    return (double)s->values[rank] / 1000.0;
+}
+
+#ifdef BENCH_PTHREADS
+/** @brief Arguments of one thread of bench_parallel_for(). */
+typedef struct {
+    /** @brief Task to run. */
+    GIF_TaskFunc task;
+    /** @brief Task data. */
+    void *task_data;
+    /** @brief Task index. */
+    int index;
+} BenchThread;
+
+/** @brief Thread entry point running one task. */
+static void *bench_thread_main(void *arg) {
+    BenchThread *t = (BenchThread*)arg;
+    t->task(t->task_data, t->index);
+    return NULL;
+}
+
+/**
+ * @brief GIF_ParallelFor over one POSIX thread per task.
+ */
+static void bench_parallel_for(void *user_data, int count, GIF_TaskFunc task, void *task_data) {
+    pthread_t threads[BENCH_WORKERS];
+    BenchThread args[BENCH_WORKERS];
+    int i, started = 0;
+    (void)user_data;
+    for (i = 0; i < count && i < BENCH_WORKERS; i++) {
+        args[i].task = task;
+        args[i].task_data = task_data;
+        args[i].index = i;
+        if (pthread_create(&threads[i], NULL, bench_thread_main, &args[i]) != 0) {
+            break;
+        }
+        started++;
+    }
+    for (i = started; i < count; i++) { // Run what could not get a thread here
+        task(task_data, i);
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+#define BENCH_PARALLEL_FOR bench_parallel_for
+#else
+#define BENCH_PARALLEL_FOR NULL
+#endif
+
+/**
+ * @brief Measures one run of one engine on one input and writes its JSON line.
+ * @param out Result stream.
+ * @param in Input to decode.
+ * @param engine Engine index.
+ * @param run Run number.
+ * @param opt Options.
+ * @return 0 on success, -1 if the input cannot be decoded.
+ */
+static int bench_run(FILE *out, const BenchInput *in, int engine, int run, const BenchOptions *opt) {
+    static uint8_t scratch[GIF_SCRATCH_BUFFER_REQUIRED_SIZE];
+    GIF_Context ctx;
+    GIF_FrameInfo *frames = NULL;
+    BenchSamples samples = {NULL, 0, 0};
+    uint8_t *frame_buffer = NULL, *canvas = NULL, *cache = NULL, *parallel = NULL;
+    uint64_t pixels_per_pass = 0, pixels = 0, start, elapsed = 0;
+    int width, height, frame_count, passes = 0, i, result = -1;
+
+    if (gif_init(&ctx, in->data, in->size, scratch, sizeof(scratch)) != GIF_SUCCESS ||
+        gif_get_info(&ctx, &width, &height) != GIF_SUCCESS ||
+        gif_build_frame_index(&ctx, NULL, 0, &frame_count) != GIF_SUCCESS || frame_count == 0) {
+        return -1;
+    }
+    frames = (GIF_FrameInfo*)malloc((size_t)frame_count * sizeof(GIF_FrameInfo));
+    frame_buffer = (uint8_t*)calloc((size_t)width * height * 3, 1);
+    if (!frames || !frame_buffer || gif_build_frame_index(&ctx, frames, frame_count, &frame_count) != GIF_SUCCESS) {
+        goto done;
+    }
+    for (i = 0; i < frame_count; i++) {
+        pixels_per_pass += (uint64_t)frames[i].width * frames[i].height;
+    }
+
+#ifdef GIF_MODE_TURBO
+    if (engine != BENCH_TURBO) {
+        size_t canvas_size = (size_t)width * height + GIF_LZW_COPY_CHUNK;
+        canvas = (uint8_t*)malloc(canvas_size);
+        if (!canvas || gif_set_index_canvas(&ctx, canvas, canvas_size) != GIF_SUCCESS) {
+            goto done;
+        }
+    }
+    if (engine == BENCH_FRAME_CACHE) {
+        size_t cache_size = (size_t)width * height * frame_count + 4096;
+        cache = (uint8_t*)malloc(cache_size);
+        if (!cache || gif_set_frame_cache(&ctx, cache, cache_size) != GIF_SUCCESS) {
+            goto done;
+        }
+    }
+    if (engine == BENCH_PARALLEL) {
+        size_t parallel_size = GIF_PARALLEL_SCRATCH_SIZE(BENCH_WORKERS, in->size);
+        parallel = (uint8_t*)malloc(parallel_size);
+        if (!parallel || gif_set_parallel_decode(&ctx, BENCH_PARALLEL_FOR, NULL, BENCH_WORKERS, parallel,
+                                                 parallel_size) != GIF_SUCCESS) {
+            goto done;
+        }
+    }
+#endif
+
+    // Whole passes over the animation until the minimum time is reached; the frame
+    // cache keeps its content across passes, as in looped playback
+    do {
+        int delay_ms;
+        gif_rewind(&ctx); // The loop count of the GIF may end the animation after one pass
+        for (i = 0; i < frame_count; i++) {
+            start = bench_now_ns();
+            if (gif_next_frame(&ctx, frame_buffer, &delay_ms) != 1) {
+                goto done;
+            }
+            start = bench_now_ns() - start;
+            elapsed += start;
+            if (!bench_add_sample(&samples, start)) {
+                goto done;
+            }
+        }
+        pixels += pixels_per_pass;
+        passes++;
+    } while ((double)elapsed < opt->min_seconds * 1e9);
+
+    qsort(samples.values, samples.count, sizeof(uint64_t), bench_compare_u64);
+    fprintf(out, "{\"type\":\"result\",\"mode\":\"%s\",\"specialized\":%d,\"engine\":\"%s\",\"class\":\"%s\","
+                 "\"case\":\"%s\",\"run\":%d,\"width\":%d,\"height\":%d,\"frames\":%d,\"input_bytes\":%lu,"
+                 "\"passes\":%d,\"seconds\":%.6f,\"mb_per_s\":%.3f,\"mpix_per_s\":%.3f,"
+                 "\"frame_us_p50\":%.3f,\"frame_us_p90\":%.3f,\"frame_us_p99\":%.3f,\"frame_us_max\":%.3f}\n",
+            BENCH_MODE, BENCH_SPECIALIZED, bench_engine_names[engine], in->class_name, in->name, run, width, height,
+            frame_count, (unsigned long)in->size, passes, (double)elapsed / 1e9,
+            (double)in->size * passes / ((double)elapsed / 1e9) / 1e6, (double)pixels / ((double)elapsed / 1e9) / 1e6,
+            bench_percentile_us(&samples, 50), bench_percentile_us(&samples, 90), bench_percentile_us(&samples, 99),
+            bench_percentile_us(&samples, 100));
+    result = 0;
+
+done:
+    free(samples.values);
+    free(frames);
+    free(frame_buffer);
+    free(canvas);
+    free(cache);
+    free(parallel);
+    return result;
+}
+
+/**
+ * @brief Reads a whole file.
+ * @param path File path.
+ * @param size Receives the file size.
+ * @return File contents to free(), or NULL on error.
+ */
+static uint8_t *bench_read_file(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    uint8_t *data = NULL;
+    long length;
+
+    if (!f) {
+        return NULL;
+    }
+    if (fseek(f, 0, SEEK_END) == 0 && (length = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0) {
+        data = (uint8_t*)malloc((size_t)length);
+        if (data && fread(data, 1, (size_t)length, f) != (size_t)length) {
+            free(data);
+            data = NULL;
+        }
+        *size = (size_t)length;
+    }
+    fclose(f);
+    return data;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opt = {5, 0.2, 100, NULL};
+    BenchInput *inputs;
+    FILE *out = stdout;
+    int input_count = 0, failures = 0, i, engine, run;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value for %s\n", argv[i]);
+            return 2;
+        }
+        if (strcmp(argv[i], "-o") == 0) {
+            out = fopen(argv[++i], "w");
+            if (!out) {
+                fprintf(stderr, "Cannot open %s\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "-r") == 0) {
+            opt.runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0) {
+            opt.min_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            opt.scale = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0) {
+            opt.only_case = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [-o results.jsonl] [-r runs] [-t min_seconds] [-s scale_percent] [-c case] [file.gif ...]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    inputs = (BenchInput*)calloc((size_t)(CORPUS_DEFAULT_CASE_COUNT + argc), sizeof(BenchInput));
+    if (!inputs) {
+        return 1;
+    }
+    for (int c = 0; c < CORPUS_DEFAULT_CASE_COUNT; c++) {
+        GIF_CorpusBuffer gif;
+        if (opt.only_case && strcmp(opt.only_case, corpus_default_cases[c].name) != 0) {
+            continue;
+        }
+        if (!corpus_generate(&corpus_default_cases[c], opt.scale, GIF_MAX_WIDTH, &gif)) {
+            fprintf(stderr, "Out of memory generating %s\n", corpus_default_cases[c].name);
+            return 1;
+        }
+        inputs[input_count].name = corpus_default_cases[c].name;
+        inputs[input_count].class_name = corpus_default_cases[c].class_name;
+        inputs[input_count].data = gif.data;
+        inputs[input_count].size = gif.size;
+        input_count++;
+    }
+    for (; i < argc; i++) {
+        inputs[input_count].data = bench_read_file(argv[i], &inputs[input_count].size);
+        if (!inputs[input_count].data) {
+            fprintf(stderr, "Cannot read %s\n", argv[i]);
+            failures++;
+            continue;
+        }
+        inputs[input_count].name = argv[i];
+        inputs[input_count].class_name = "file";
+        input_count++;
+    }
+
+    fprintf(out, "{\"type\":\"meta\",\"mode\":\"%s\",\"specialized\":%d,\"max_width\":%d,\"runs\":%d,"
+                 "\"min_seconds\":%.3f,\"scale\":%d,\"workers\":%d}\n",
+            BENCH_MODE, BENCH_SPECIALIZED, GIF_MAX_WIDTH, opt.runs, opt.min_seconds, opt.scale, BENCH_WORKERS);
+    for (i = 0; i < input_count; i++) {
+        for (engine = 0; engine < BENCH_ENGINE_COUNT; engine++) {
+            for (run = 0; run < opt.runs; run++) {
+                if (bench_run(out, &inputs[i], engine, run, &opt) != 0) {
+                    fprintf(stderr, "%s: decoding failed with engine %s\n", inputs[i].name, bench_engine_names[engine]);
+                    failures++;
+                    break;
+                }
+            }
+        }
+        fflush(out);
+    }
+
+    for (i = 0; i < input_count; i++) {
+        free(inputs[i].data);
+    }
+    free(inputs);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,454 @@
+/**
+ * @file gif_corpus.h
+ * @brief Deterministic synthetic GIF corpus with a minimal LZW encoder (benchmark support).
+ *
+ * Every case is generated from its own seed, so a corpus is identical across runs and
+ * machines. Cases vary canvas size, palette size, pixel content, interlacing,
+ * transparency, local palettes, sub-block sizes and the clear-code strategy of the
+ * encoder. Include this header in a single translation unit.
+ */
+#ifndef GIF_CORPUS_H
+#define GIF_CORPUS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Pixel content of the frames of a case. */
+enum {
+    /** @brief Uniformly random indices: short LZW strings, worst case for the decoder. */
+    CORPUS_NOISE,
+    /** @brief One color per frame: long LZW strings, best case. */
+    CORPUS_FLAT,
+    /** @brief Diagonal stripes: repetitive medium-length strings. */
+    CORPUS_STRIPES,
+    /** @brief Horizontal gradient: long runs of each color along every row. */
+    CORPUS_GRADIENT,
+    /** @brief Random-length runs of random colors, like cartoons and screen captures. */
+    CORPUS_RUNS
+};
+
+/** @brief Clear-code strategy of the encoder. */
+enum {
+    /** @brief Emit a clear code whenever the dictionary is full (most encoders). */
+    CORPUS_CLEAR_WHEN_FULL,
+    /** @brief Keep the full dictionary frozen until the end of the frame (deferred clear). */
+    CORPUS_CLEAR_DEFERRED
+};
+
+/** @brief Parameters of one generated GIF. */
+typedef struct {
+    /** @brief Name of the case in benchmark results. */
+    const char *name;
+    /** @brief Class of the case, used to group results. */
+    const char *class_name;
+    /** @brief Canvas width. */
+    int width;
+    /** @brief Canvas height. */
+    int height;
+    /** @brief Number of frames. */
+    int frames;
+    /** @brief Global palette size in bits (1 to 8). */
+    int palette_bits;
+    /** @brief Pixel content (CORPUS_NOISE...). */
+    int content;
+    /** @brief Clear-code strategy (CORPUS_CLEAR_WHEN_FULL or CORPUS_CLEAR_DEFERRED). */
+    int clear_mode;
+    /** @brief Emit an extra clear code every this many codes; 0 for none. */
+    int clear_every;
+    /** @brief Interlace every frame. */
+    int interlaced;
+    /** @brief Percentage of frames with a transparent color. */
+    int transparency_percent;
+    /** @brief Percentage of frames after the first covering a random sub-rectangle only. */
+    int subrect_percent;
+    /** @brief Percentage of frames with a local palette. */
+    int local_palette_percent;
+    /** @brief Size of the LZW data sub-blocks (1 to 255). */
+    int sub_block_size;
+    /** @brief Seed of the case. */
+    uint32_t seed;
+} GIF_CorpusCase;
+
+/** @brief Growable output buffer. */
+typedef struct {
+    /** @brief Data written so far. */
+    uint8_t *data;
+    /** @brief Number of bytes written. */
+    size_t size;
+    /** @brief Allocated size of `data`. */
+    size_t capacity;
+} GIF_CorpusBuffer;
+
+/** @brief Default corpus; `scale` of corpus_generate() multiplies the canvas sizes. */
+static const GIF_CorpusCase corpus_default_cases[] = {
+    {"noise-256", "noise", 256, 256, 4, 8, CORPUS_NOISE, CORPUS_CLEAR_WHEN_FULL, 0, 0, 0, 0, 0, 255, 1},
+    {"noise-16c", "noise", 320, 240, 4, 4, CORPUS_NOISE, CORPUS_CLEAR_WHEN_FULL, 0, 0, 0, 0, 0, 255, 2},
+    {"noise-deferred", "noise", 256, 256, 4, 8, CORPUS_NOISE, CORPUS_CLEAR_DEFERRED, 0, 0, 0, 0, 0, 255, 3},
+    {"flat", "flat", 480, 360, 8, 8, CORPUS_FLAT, CORPUS_CLEAR_WHEN_FULL, 0, 0, 0, 0, 0, 255, 4},
+    {"stripes", "pattern", 480, 360, 6, 5, CORPUS_STRIPES, CORPUS_CLEAR_WHEN_FULL, 0, 0, 0, 0, 0, 255, 5},
+    {"gradient", "pattern", 480, 360, 6, 6, CORPUS_GRADIENT, CORPUS_CLEAR_DEFERRED, 0, 0, 0, 0, 0, 255, 6},
+    {"cartoon", "runs", 400, 300, 12, 7, CORPUS_RUNS, CORPUS_CLEAR_WHEN_FULL, 0, 0, 30, 50, 20, 255, 7},
+    {"cartoon-interlaced", "interlaced", 400, 300, 8, 7, CORPUS_RUNS, CORPUS_CLEAR_WHEN_FULL, 0, 1, 30, 0, 0, 255, 8},
+    {"sticker", "transparent", 240, 240, 16, 6, CORPUS_RUNS, CORPUS_CLEAR_WHEN_FULL, 0, 0, 100, 60, 0, 255, 9},
+    {"clear-every-64", "clear-codes", 320, 240, 4, 8, CORPUS_RUNS, CORPUS_CLEAR_WHEN_FULL, 64, 0, 0, 0, 0, 255, 10},
+    {"tiny-sub-blocks", "sub-blocks", 320, 240, 4, 8, CORPUS_RUNS, CORPUS_CLEAR_WHEN_FULL, 0, 0, 0, 0, 0, 7, 11},
+    {"large-photo", "large", 1024, 768, 2, 8, CORPUS_NOISE, CORPUS_CLEAR_WHEN_FULL, 1000, 0, 0, 0, 0, 255, 12},
+    {"large-screen", "large", 1024, 768, 3, 8, CORPUS_RUNS, CORPUS_CLEAR_WHEN_FULL, 1000, 0, 0, 0, 0, 255, 13}
+};
+
+/** @brief Number of cases in corpus_default_cases. */
+#define CORPUS_DEFAULT_CASE_COUNT ((int)(sizeof(corpus_default_cases) / sizeof(corpus_default_cases[0])))
+
+/**
+ * @brief Advances the xorshift32 generator of a case.
+ * @param state Generator state (never 0).
+ * @return Next pseudo-random value.
+ */
+static uint32_t corpus_random(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Returns a pseudo-random value in [0, n).
+ * @param state Generator state.
+ * @param n Upper bound (non-zero).
+ * @return Value below `n`.
+ */
+static uint32_t corpus_below(uint32_t *state, uint32_t n) {
+    return corpus_random(state) % n;
+}
+
+/**
+ * @brief Appends bytes to a buffer, growing it as needed.
+ * @param buf Output buffer.
+ * @param data Bytes to append.
+ * @param len Number of bytes.
+ * @return 1 on success, 0 if out of memory.
+ */
+static int corpus_put(GIF_CorpusBuffer *buf, const void *data, size_t len) {
+    if (buf->size + len > buf->capacity) {
+        size_t capacity = buf->capacity ? buf->capacity : 4096;
+        uint8_t *grown;
+        while (capacity < buf->size + len) {
+            capacity *= 2;
+        }
+        grown = (uint8_t*)realloc(buf->data, capacity);
+        if (!grown) {
+            return 0;
+        }
+        buf->data = grown;
+        buf->capacity = capacity;
+    }
+    memcpy(buf->data + buf->size, data, len);
+    buf->size += len;
+    return 1;
+}
+
+/**
+ * @brief Appends one byte to a buffer.
+ * @param buf Output buffer.
+ * @param value Byte to append.
+ * @return 1 on success, 0 if out of memory.
+ */
+static int corpus_put_byte(GIF_CorpusBuffer *buf, uint8_t value) {
+    return corpus_put(buf, &value, 1);
+}
+
+/**
+ * @brief Appends a little-endian 16-bit value to a buffer.
+ * @param buf Output buffer.
+ * @param value Value to append.
+ * @return 1 on success, 0 if out of memory.
+ */
+static int corpus_put_u16(GIF_CorpusBuffer *buf, uint16_t value) {
+    uint8_t bytes[2];
+    bytes[0] = (uint8_t)(value & 0xFF);
+    bytes[1] = (uint8_t)(value >> 8);
+    return corpus_put(buf, bytes, 2);
+}
+
+/** @brief State of the LZW encoder while it packs codes into sub-blocks. */
+typedef struct {
+    /** @brief Output buffer. */
+    GIF_CorpusBuffer *out;
+    /** @brief Pending sub-block. */
+    uint8_t block[255];
+    /** @brief Bytes in `block`. */
+    int block_len;
+    /** @brief Size at which sub-blocks are flushed. */
+    int block_size;
+    /** @brief Bit accumulator. */
+    uint32_t bits;
+    /** @brief Number of bits in `bits`. */
+    int bit_count;
+    /** @brief Set if the output ran out of memory. */
+    int failed;
+} GIF_CorpusBitWriter;
+
+/**
+ * @brief Appends a byte to the pending sub-block, flushing it when full.
+ * @param w Bit writer.
+ * @param value Byte to append.
+ */
+static void corpus_block_byte(GIF_CorpusBitWriter *w, uint8_t value) {
+    w->block[w->block_len++] = value;
+    if (w->block_len == w->block_size) {
+        w->failed |= !corpus_put_byte(w->out, (uint8_t)w->block_len) || !corpus_put(w->out, w->block, (size_t)w->block_len);
+        w->block_len = 0;
+    }
+}
+
+/**
+ * @brief Writes one LZW code, least significant bit first.
+ * @param w Bit writer.
+ * @param code Code to write.
+ * @param size Code size in bits.
+ */
+static void corpus_write_code(GIF_CorpusBitWriter *w, uint32_t code, int size) {
+    w->bits |= code << w->bit_count;
+    w->bit_count += size;
+    while (w->bit_count >= 8) {
+        corpus_block_byte(w, (uint8_t)(w->bits & 0xFF));
+        w->bits >>= 8;
+        w->bit_count -= 8;
+    }
+}
+
+/** @brief Slots of the open-addressing string table of the encoder (power of two, above 4096). */
+#define CORPUS_LZW_HASH_SIZE 8192
+
+/**
+ * @brief LZW-encodes a frame into GIF sub-blocks, ending with the block terminator.
+ * @param out Output buffer.
+ * @param indices Palette indices in stream order (interlaced rows already reordered).
+ * @param count Number of indices.
+ * @param min_size Initial LZW code size (2 to 8).
+ * @param clear_mode CORPUS_CLEAR_WHEN_FULL or CORPUS_CLEAR_DEFERRED.
+ * @param clear_every Emit an extra clear code every this many codes; 0 for none.
+ * @param block_size Size of the data sub-blocks (1 to 255).
+ * @return 1 on success, 0 if out of memory.
+ */
+static int corpus_lzw_encode(GIF_CorpusBuffer *out, const uint8_t *indices, size_t count, int min_size,
+                             int clear_mode, int clear_every, int block_size) {
+    static int32_t keys[CORPUS_LZW_HASH_SIZE]; // (prefix << 8 | byte) + 1, 0 for an empty slot
+    static uint16_t codes[CORPUS_LZW_HASH_SIZE];
+    const uint32_t clear = 1u << min_size, eoi = clear + 1;
+    GIF_CorpusBitWriter w;
+    uint32_t next_code = eoi + 1, prefix;
+    int size = min_size + 1, emitted = 0;
+    size_t i;
+
+    memset(&w, 0, sizeof(w));
+    w.out = out;
+    w.block_size = block_size;
+    memset(keys, 0, sizeof(keys));
+    corpus_write_code(&w, clear, size);
+    if (count == 0) {
+        corpus_write_code(&w, eoi, size);
+    } else {
+        prefix = indices[0];
+        for (i = 1; i < count; i++) {
+            int32_t key = (int32_t)((prefix << 8) | indices[i]) + 1;
+            uint32_t slot = ((uint32_t)key * 2654435761u) >> (32 - 13);
+            while (keys[slot] && keys[slot] != key) {
+                slot = (slot + 1) & (CORPUS_LZW_HASH_SIZE - 1);
+            }
+            if (keys[slot]) { // The string is in the dictionary: extend it
+                prefix = codes[slot];
+                continue;
+            }
+            corpus_write_code(&w, prefix, size);
+            emitted++;
+            if (next_code < 4096) {
+                keys[slot] = key;
+                codes[slot] = (uint16_t)next_code++;
+                if (next_code > (1u << size) && size < 12) {
+                    size++;
+                }
+            } else if (clear_mode == CORPUS_CLEAR_WHEN_FULL) {
+                corpus_write_code(&w, clear, size);
+                memset(keys, 0, sizeof(keys));
+                next_code = eoi + 1;
+                size = min_size + 1;
+            }
+            if (clear_every && emitted % clear_every == 0) {
+                corpus_write_code(&w, clear, size);
+                memset(keys, 0, sizeof(keys));
+                next_code = eoi + 1;
+                size = min_size + 1;
+            }
+            prefix = indices[i];
+        }
+        corpus_write_code(&w, prefix, size);
+        corpus_write_code(&w, eoi, size);
+    }
+    if (w.bit_count > 0) {
+        corpus_block_byte(&w, (uint8_t)(w.bits & 0xFF));
+    }
+    if (w.block_len > 0) {
+        w.failed |= !corpus_put_byte(out, (uint8_t)w.block_len) || !corpus_put(out, w.block, (size_t)w.block_len);
+    }
+    w.failed |= !corpus_put_byte(out, 0); // Block terminator
+    return !w.failed;
+}
+
+/**
+ * @brief Fills the palette indices of a frame in row order.
+ * @param c Case being generated.
+ * @param rng Generator state.
+ * @param pixels Destination (`width * height` entries).
+ * @param width Frame width.
+ * @param height Frame height.
+ * @param colors Number of usable colors.
+ */
+static void corpus_fill_pixels(const GIF_CorpusCase *c, uint32_t *rng, uint8_t *pixels, int width, int height, int colors) {
+    size_t i, count = (size_t)width * height;
+    int x, y;
+
+    switch (c->content) {
+        case CORPUS_NOISE:
+            for (i = 0; i < count; i++) {
+                pixels[i] = (uint8_t)corpus_below(rng, (uint32_t)colors);
+            }
+            break;
+        case CORPUS_FLAT:
+            memset(pixels, (int)corpus_below(rng, (uint32_t)colors), count);
+            break;
+        case CORPUS_STRIPES: {
+            int shift = (int)corpus_below(rng, (uint32_t)colors);
+            for (y = 0; y < height; y++) {
+                for (x = 0; x < width; x++) {
+                    pixels[(size_t)y * width + x] = (uint8_t)((x / 3 + y + shift) % colors);
+                }
+            }
+            break;
+        }
+        case CORPUS_GRADIENT:
+            for (y = 0; y < height; y++) {
+                for (x = 0; x < width; x++) {
+                    pixels[(size_t)y * width + x] = (uint8_t)((size_t)x * colors / width);
+                }
+            }
+            break;
+        default:
+            for (i = 0; i < count;) {
+                size_t run = 1 + corpus_below(rng, 300);
+                uint8_t color = (uint8_t)corpus_below(rng, (uint32_t)colors);
+                if (run > count - i) {
+                    run = count - i;
+                }
+                memset(pixels + i, color, run);
+                i += run;
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Generates the GIF of one case.
+ * @param c Case to generate.
+ * @param scale Multiplier of the canvas size, in percent (100 keeps the case size).
+ * @param max_width Largest canvas width the decoder accepts; wider cases are narrowed.
+ * @param out Receives the GIF; release `out->data` with free().
+ * @return 1 on success, 0 if out of memory.
+ */
+static int corpus_generate(const GIF_CorpusCase *c, int scale, int max_width, GIF_CorpusBuffer *out) {
+    static const int pass_offset[] = {0, 4, 2, 1}, pass_stride[] = {8, 8, 4, 2};
+    uint32_t rng = c->seed * 2654435761u + 1;
+    int width = c->width * scale / 100, height = c->height * scale / 100;
+    int f, ok = 1;
+    uint8_t palette[256 * 3], *pixels, *stream;
+
+    if (width > max_width) width = max_width;
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    if (height > 65535) height = 65535;
+    memset(out, 0, sizeof(*out));
+    pixels = (uint8_t*)malloc((size_t)width * height);
+    stream = (uint8_t*)malloc((size_t)width * height);
+    if (!pixels || !stream) {
+        free(pixels);
+        free(stream);
+        return 0;
+    }
+
+    ok &= corpus_put(out, "GIF89a", 6);
+    ok &= corpus_put_u16(out, (uint16_t)width);
+    ok &= corpus_put_u16(out, (uint16_t)height);
+    ok &= corpus_put_byte(out, (uint8_t)(0x80 | (c->palette_bits - 1))); // Global Color Table
+    ok &= corpus_put_byte(out, 0); // Background color index
+    ok &= corpus_put_byte(out, 0); // Pixel aspect ratio
+    for (f = 0; f < (3 << c->palette_bits); f++) {
+        palette[f] = (uint8_t)corpus_random(&rng);
+    }
+    ok &= corpus_put(out, palette, (size_t)3 << c->palette_bits);
+    if (c->frames > 1) {
+        ok &= corpus_put(out, "\x21\xFF\x0BNETSCAPE2.0\x03\x01\x00\x00\x00", 19);
+    }
+
+    for (f = 0; f < c->frames && ok; f++) {
+        int fw = width, fh = height, fx = 0, fy = 0, bits = c->palette_bits, y, pass;
+        int local = (int)corpus_below(&rng, 100) < c->local_palette_percent;
+        int transparent = (int)corpus_below(&rng, 100) < c->transparency_percent;
+        size_t rows = 0;
+
+        if (f > 0 && (int)corpus_below(&rng, 100) < c->subrect_percent) {
+            fw = 1 + (int)corpus_below(&rng, (uint32_t)width);
+            fh = 1 + (int)corpus_below(&rng, (uint32_t)height);
+            fx = (int)corpus_below(&rng, (uint32_t)(width - fw + 1));
+            fy = (int)corpus_below(&rng, (uint32_t)(height - fh + 1));
+        }
+        if (local) {
+            bits = 1 + (int)corpus_below(&rng, 8);
+        }
+        corpus_fill_pixels(c, &rng, pixels, fw, fh, 1 << bits);
+
+        ok &= corpus_put(out, "\x21\xF9\x04", 3); // Graphic Control Extension
+        ok &= corpus_put_byte(out, (uint8_t)((transparent ? 1 : 0) | ((1 + corpus_below(&rng, 2)) << 2)));
+        ok &= corpus_put_u16(out, (uint16_t)(2 + corpus_below(&rng, 8)));
+        ok &= corpus_put_byte(out, (uint8_t)corpus_below(&rng, 1u << bits));
+        ok &= corpus_put_byte(out, 0);
+
+        ok &= corpus_put_byte(out, 0x2C); // Image Descriptor
+        ok &= corpus_put_u16(out, (uint16_t)fx);
+        ok &= corpus_put_u16(out, (uint16_t)fy);
+        ok &= corpus_put_u16(out, (uint16_t)fw);
+        ok &= corpus_put_u16(out, (uint16_t)fh);
+        ok &= corpus_put_byte(out, (uint8_t)((local ? 0x80 | (bits - 1) : 0) | (c->interlaced ? 0x40 : 0)));
+        if (local) {
+            for (y = 0; y < (3 << bits); y++) {
+                palette[y] = (uint8_t)corpus_random(&rng);
+            }
+            ok &= corpus_put(out, palette, (size_t)3 << bits);
+        }
+
+        // Rows go into the stream in interlacing order
+        for (pass = 0; pass < (c->interlaced ? 4 : 1); pass++) {
+            int first = c->interlaced ? pass_offset[pass] : 0, stride = c->interlaced ? pass_stride[pass] : 1;
+            for (y = first; y < fh; y += stride) {
+                memcpy(stream + rows * fw, pixels + (size_t)y * fw, (size_t)fw);
+                rows++;
+            }
+        }
+        ok &= corpus_put_byte(out, (uint8_t)(bits < 2 ? 2 : bits));
+        ok &= corpus_lzw_encode(out, stream, (size_t)fw * fh, bits < 2 ? 2 : bits, c->clear_mode, c->clear_every,
+                                c->sub_block_size);
+    }
+    ok &= corpus_put_byte(out, 0x3B); // Trailer
+
+    free(pixels);
+    free(stream);
+    if (!ok) {
+        free(out->data);
+        memset(out, 0, sizeof(*out));
+    }
+    return ok;
+}
+
+#endif // GIF_CORPUS_H
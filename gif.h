@@ -42,6 +42,24 @@ extern "C" {
  */
 // #define GIF_MODE_TURBO
 
+/**
+ * @brief Define GIF_NO_LZW_SPECIALIZATION to build a single LZW decode loop.
+ *
+ * By default the decode loop is instantiated once per initial LZW code size (2 to 8),
+ * so the code-size dependent constants are folded into each copy. This trades code size
+ * for speed; defining this macro keeps one generic loop for memory-constrained targets.
+ */
+// #define GIF_NO_LZW_SPECIALIZATION
+
+/**
+ * @brief Define GIF_ENABLE_STATS to count hot-path events in GIF_Context::stats.
+ *
+ * Counts LZW codes, clear codes, dictionary-full stretches, LZW buffer refills, bytes
+ * shifted by memmove, rendered rows and skipped transparent pixels (see GIF_Stats and
+ * gif_format_stats()). Without it the counters and their updates compile to nothing.
+ */
+// #define GIF_ENABLE_STATS
+
 /**
  * @brief Maximum supported GIF canvas width.
  * Can be overridden by defining GIF_MAX_WIDTH before including this header.
@@ -72,6 +90,21 @@ extern "C" {
 #define GIF_LZW_BASE_BUF_SIZE (6 * GIF_LZW_CHUNK_SIZE)
 /** @brief Number of entries in the LZW table. */
 #define GIF_LZW_TABLE_ENTRIES (1 << GIF_MAX_CODE_SIZE) // 4096 entries
+/** @brief Upper bound on the length of a single LZW string (one new byte per dictionary entry). */
+#define GIF_LZW_MAX_STRING_LEN GIF_LZW_TABLE_ENTRIES
+
+/** @brief Alignment (one cache line) of the regions carved out of the scratch buffer in Turbo mode. */
+#define GIF_SCRATCH_ALIGN 64
+/** @brief Rounds a region size up to a multiple of GIF_SCRATCH_ALIGN. */
+#define GIF_SCRATCH_ALIGN_UP(size) (((size) + (GIF_SCRATCH_ALIGN - 1)) & ~(size_t)(GIF_SCRATCH_ALIGN - 1))
+/**
+ * @brief Step of the over-copying LZW string copies in Turbo mode.
+ * Regions written by these copies carry this many bytes of guard padding.
+ */
+#define GIF_LZW_COPY_CHUNK 16
+
+/** @brief Line buffer size (one row plus the longest LZW string that may complete it). */
+#define GIF_SCRATCH_LINE_BUF_SIZE (GIF_MAX_WIDTH + GIF_LZW_MAX_STRING_LEN)
 
 /**
  * @brief Defines the minimum required size for the internal scratch buffer.
@@ -79,27 +112,106 @@ extern "C" {
  * The user must provide a buffer of at least this size to gif_init().
  */
 #ifdef GIF_MODE_TURBO
-    /** @brief Size of the LZW dictionary symbols for Turbo mode. */
-    #define GIF_SCRATCH_LZW_DICT_SYMBOLS_SIZE (GIF_LZW_TABLE_ENTRIES * sizeof(uint32_t))
-    /** @brief Size of the LZW dictionary lengths for Turbo mode. */
-    #define GIF_SCRATCH_LZW_DICT_LENGTHS_SIZE (GIF_LZW_TABLE_ENTRIES * sizeof(uint16_t))
-    /** @brief Size of the LZW pixels suffix buffer for Turbo mode. */
-    #define GIF_SCRATCH_LZW_PIXELS_SUFFIX_SIZE (GIF_LZW_TABLE_ENTRIES * sizeof(uint8_t))
+    /** @brief Size of one packed LZW dictionary entry for Turbo mode (see GIF_LZWEntry). */
+    #define GIF_LZW_DICT_ENTRY_SIZE 8
+    /** @brief Size of the packed LZW dictionary for Turbo mode. */
+    #define GIF_SCRATCH_LZW_DICT_SIZE (GIF_LZW_TABLE_ENTRIES * GIF_LZW_DICT_ENTRY_SIZE)
+    /** @brief Size of the buffer holding materialized LZW strings for Turbo mode. */
+    #define GIF_SCRATCH_LZW_STRINGS_SIZE (GIF_LZW_TABLE_ENTRIES * 4)
+    /** @brief Guard padding after the Turbo-mode regions touched by over-copying string copies. */
+    #define GIF_SCRATCH_LZW_COPY_PAD GIF_LZW_COPY_CHUNK
     /** @brief Main LZW buffer size for Turbo mode. */
-    #define GIF_SCRATCH_LZW_MAIN_BUF_SIZE (GIF_LZW_BASE_BUF_SIZE + (2 * GIF_LZW_TABLE_ENTRIES) + (GIF_LZW_TABLE_ENTRIES * 2) + GIF_MAX_WIDTH)
-    /** @brief Total required scratch buffer size for Turbo mode. */
-    #define GIF_SCRATCH_BUFFER_REQUIRED_SIZE (GIF_SCRATCH_LZW_MAIN_BUF_SIZE + GIF_SCRATCH_LZW_DICT_SYMBOLS_SIZE + GIF_SCRATCH_LZW_DICT_LENGTHS_SIZE + GIF_SCRATCH_LZW_PIXELS_SUFFIX_SIZE + GIF_MAX_WIDTH)
+    #define GIF_SCRATCH_LZW_MAIN_BUF_SIZE GIF_LZW_BASE_BUF_SIZE
+    /** @brief Total required scratch buffer size for Turbo mode (including slack for the 64-byte alignment). */
+    #define GIF_SCRATCH_BUFFER_REQUIRED_SIZE (GIF_SCRATCH_ALIGN - 1 + GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_DICT_SIZE) + GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_STRINGS_SIZE + GIF_SCRATCH_LZW_COPY_PAD) + GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_MAIN_BUF_SIZE) + GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LINE_BUF_SIZE + GIF_SCRATCH_LZW_COPY_PAD))
 #else
     /** @brief Size of the LZW table for Safe mode. */
     #define GIF_SCRATCH_LZW_TABLE_SIZE (GIF_LZW_TABLE_ENTRIES * sizeof(uint16_t))
+    /** @brief Size of the LZW string lengths for Safe mode. */
+    #define GIF_SCRATCH_LZW_LENGTHS_SIZE (GIF_LZW_TABLE_ENTRIES * sizeof(uint16_t))
     /** @brief Size of the LZW pixels buffer for Safe mode. */
     #define GIF_SCRATCH_LZW_PIXELS_SIZE (GIF_LZW_TABLE_ENTRIES * 2 * sizeof(uint8_t))
     /** @brief Main LZW buffer size for Safe mode. */
     #define GIF_SCRATCH_LZW_MAIN_BUF_SIZE GIF_LZW_BASE_BUF_SIZE
-    /** @brief Total required scratch buffer size for Safe mode. */
-    #define GIF_SCRATCH_BUFFER_REQUIRED_SIZE (GIF_SCRATCH_LZW_MAIN_BUF_SIZE + GIF_SCRATCH_LZW_TABLE_SIZE + GIF_SCRATCH_LZW_PIXELS_SIZE + GIF_MAX_WIDTH)
+    /** @brief Total required scratch buffer size for Safe mode (including one byte of slack to align the 16-bit tables). */
+    #define GIF_SCRATCH_BUFFER_REQUIRED_SIZE (sizeof(uint16_t) - 1 + GIF_SCRATCH_LZW_TABLE_SIZE + GIF_SCRATCH_LZW_LENGTHS_SIZE + GIF_SCRATCH_LZW_MAIN_BUF_SIZE + GIF_SCRATCH_LZW_PIXELS_SIZE + GIF_SCRATCH_LINE_BUF_SIZE)
+#endif
+
+#ifdef GIF_MODE_TURBO
+/**
+ * @brief Maximum number of segments a frame is split into for parallel decoding.
+ * Can be overridden by defining GIF_PARALLEL_MAX_SEGMENTS before including this header.
+ */
+#ifndef GIF_PARALLEL_MAX_SEGMENTS
+#define GIF_PARALLEL_MAX_SEGMENTS 64
+#endif
+
+/**
+ * @brief Minimum number of pixels in a frame for parallel decoding to be attempted.
+ * Can be overridden by defining GIF_PARALLEL_MIN_PIXELS before including this header.
+ */
+#ifndef GIF_PARALLEL_MIN_PIXELS
+#define GIF_PARALLEL_MIN_PIXELS (256 * 1024)
+#endif
+
+/**
+ * @brief Size of the scratch buffer for parallel decoding (see gif_set_parallel_decode()).
+ *
+ * One LZW dictionary per worker, the segment table, and room for `lzw_bytes` bytes of
+ * LZW data of a frame. The size of the GIF file is always enough for `lzw_bytes`.
+ */
+#define GIF_PARALLEL_SCRATCH_SIZE(workers, lzw_bytes) (GIF_SCRATCH_ALIGN - 1 + (size_t)(workers) * GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_DICT_SIZE) + GIF_SCRATCH_ALIGN_UP(GIF_PARALLEL_MAX_SEGMENTS * sizeof(GIF_LZWSegment)) + (size_t)(lzw_bytes))
+
+/**
+ * @brief Size of the caller memory for a pipeline of `slots` frames (see gif_pipeline_init()).
+ * `plane_size` is the index plane size of a slot, usually canvas `width * height` plus
+ * GIF_LZW_COPY_CHUNK.
+ */
+#define GIF_PIPELINE_MEMORY_SIZE(slots, plane_size) (GIF_SCRATCH_ALIGN - 1 + GIF_SCRATCH_ALIGN_UP((size_t)(slots) * sizeof(GIF_PipelineSlot)) + (size_t)(slots) * GIF_SCRATCH_ALIGN_UP(plane_size))
+
+/** @brief Returned by gif_pipeline_push() when the ring is full and by gif_pipeline_pop() when it is empty. */
+#define GIF_PIPELINE_BUSY 2
+
+/** @brief Scratch size of one worker of gif_decode_frame_planes() (LZW dictionary and LZW buffer). */
+#define GIF_WORKER_SCRATCH_SIZE (GIF_SCRATCH_ALIGN - 1 + GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_DICT_SIZE) + GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_MAIN_BUF_SIZE))
 #endif
 
+/**
+ * @brief Size of the scratch buffer for gif_decode_batch() with `workers` workers.
+ * Each worker gets one decoder scratch buffer and one cache line for its job queue.
+ */
+#define GIF_BATCH_SCRATCH_SIZE(workers) (GIF_SCRATCH_ALIGN - 1 + (size_t)(workers) * (GIF_SCRATCH_ALIGN + GIF_SCRATCH_BUFFER_REQUIRED_SIZE))
+
+/** @brief Returned by gif_player_present() when the next frame is not decoded yet. */
+#define GIF_PLAYER_LATE 2
+
+/**
+ * @brief Frame delays below this many milliseconds are replaced by GIF_CLAMPED_DELAY_MS in
+ * gif_analyze(), as browsers do. Can be overridden by defining it before including this header.
+ */
+#ifndef GIF_MIN_DELAY_MS
+#define GIF_MIN_DELAY_MS 20
+#endif
+
+/**
+ * @brief Delay that gif_analyze() uses for frames with delays below GIF_MIN_DELAY_MS.
+ * Can be overridden by defining it before including this header.
+ */
+#ifndef GIF_CLAMPED_DELAY_MS
+#define GIF_CLAMPED_DELAY_MS 100
+#endif
+
+/**
+ * @brief Side in pixels of the square tiles of the static-region mask of gif_analyze().
+ * Can be overridden by defining it before including this header.
+ */
+#ifndef GIF_ANALYSIS_TILE
+#define GIF_ANALYSIS_TILE 16
+#endif
+
+/** @brief Size of the static-region mask of gif_analyze() for a `width * height` canvas (one byte per tile). */
+#define GIF_ANALYSIS_MASK_SIZE(width, height) ((((size_t)(width) + GIF_ANALYSIS_TILE - 1) / GIF_ANALYSIS_TILE) * (((size_t)(height) + GIF_ANALYSIS_TILE - 1) / GIF_ANALYSIS_TILE))
+
 // --- Error Codes ---
 /**
  * @brief Enumeration of error codes that can be returned by the library.
@@ -134,7 +246,248 @@ enum {
  */
 typedef void (*GIF_ErrorCallback)(int error_code, const char* message);
 
+/**
+ * @brief Type definition for a task run by a GIF_ParallelFor callback.
+ * @param task_data Opaque data passed through from the library.
+ * @param index Index of the task, from 0 to `count - 1`.
+ */
+typedef void (*GIF_TaskFunc)(void *task_data, int index);
+
+/**
+ * @brief Type definition for a caller-provided parallel-for callback.
+ *
+ * The library creates no threads. The callback must call `task(task_data, i)` once for
+ * every `i` from 0 to `count - 1`, possibly concurrently, and return only after all
+ * calls have completed.
+ * @param user_data User data registered along with the callback.
+ * @param count Number of tasks.
+ * @param task Task function.
+ * @param task_data Data to pass to every task.
+ */
+typedef void (*GIF_ParallelFor)(void *user_data, int count, GIF_TaskFunc task, void *task_data);
+
+#ifdef GIF_ENABLE_STATS
+/**
+ * @brief Hot-path event counters of a context (only with GIF_ENABLE_STATS).
+ *
+ * Counters accumulate from gif_init() until gif_reset_stats(). Work done on context
+ * copies (parallel segments, gif_decode_frame_planes()) is not counted.
+ */
+typedef struct {
+    /** @brief Frames decoded from LZW data. */
+    uint64_t frames_decoded;
+    /** @brief Frames rendered without LZW decoding (repeated frames, index canvas, frame cache). */
+    uint64_t frames_reused;
+    /** @brief LZW codes read, including clear and End Of Information codes. */
+    uint64_t codes;
+    /** @brief Clear codes read. */
+    uint64_t clear_codes;
+    /** @brief Stretches decoded with a full (frozen) dictionary. */
+    uint64_t dictionary_full;
+    /** @brief Palette indices emitted by the LZW decoders; divided by data codes, the average string length. */
+    uint64_t indices;
+    /** @brief Calls that refilled the LZW buffer from the sub-blocks. */
+    uint64_t refills;
+    /** @brief Bytes shifted by memmove in the LZW and line buffers. */
+    uint64_t bytes_moved;
+    /** @brief Rows rendered into the frame buffer. */
+    uint64_t rows_rendered;
+    /** @brief Transparent pixels left untouched in the frame buffer. */
+    uint64_t transparent_skipped;
+} GIF_Stats;
+#endif
+
+/**
+ * @brief Type definition for a caller-provided clock used for timings.
+ * @param user_data User data registered along with the callback.
+ * @return Current time in caller-defined ticks (e.g. nanoseconds of a monotonic clock).
+ */
+typedef uint64_t (*GIF_ClockFunc)(void *user_data);
+
+/**
+ * @brief One GIF of a gif_decode_batch() call.
+ */
+typedef struct {
+    /** @brief Pointer to the raw GIF data. */
+    const uint8_t *data;
+    /** @brief Size of the GIF data. */
+    size_t size;
+    /** @brief RGB888 frame buffer receiving the canvas after the last decoded frame. */
+    uint8_t *frame_buffer;
+    /** @brief Size of `frame_buffer`; canvas `width * height * 3` bytes are needed. */
+    size_t frame_buffer_size;
+    /** @brief Number of frames to decode; 0 decodes every frame once. */
+    int max_frames;
+
+    /** @brief Result (GIF_SUCCESS or an error code; GIF_ERROR_DECODE if a frame failed to decode). */
+    int result;
+    /** @brief Width of the GIF canvas (0 if the header could not be read). */
+    int width;
+    /** @brief Height of the GIF canvas (0 if the header could not be read). */
+    int height;
+    /** @brief Number of frames rendered into `frame_buffer`. */
+    int frames_decoded;
+    /** @brief Worker that decoded the GIF. */
+    int worker;
+    /** @brief Time spent on the GIF in clock ticks (0 without a clock). */
+    uint64_t elapsed;
+} GIF_BatchJob;
+
 // --- Context Structure ---
+/**
+ * @brief Packed LZW dictionary entry used by Turbo mode.
+ *
+ * One entry is 8 bytes, so with the 64-byte aligned dictionary every lookup touches
+ * a single cache line.
+ */
+typedef struct {
+    /**
+     * @brief Offset of the string in the string buffer.
+     * If GIF_LZW_ENTRY_PENDING is set, the string is not materialized yet and the
+     * low bits hold its prefix code instead.
+     */
+    uint32_t offset;
+    /** @brief Length of the string in bytes; GIF_LZW_LENGTH_RUN marks a single repeated byte. */
+    uint16_t length;
+    /** @brief First byte of the string. */
+    uint8_t first;
+    /** @brief Last byte of the string (the suffix appended to the prefix). */
+    uint8_t last;
+} GIF_LZWEntry;
+
+/**
+ * @brief Independently decodable part of a frame's LZW data, used by parallel decoding.
+ *
+ * Every segment but the first starts right after a clear code, so it needs no dictionary
+ * state from the segments before it.
+ */
+typedef struct {
+    /** @brief Byte offset of the segment in the frame's LZW data. */
+    uint32_t byte_pos;
+    /** @brief Bit offset of the segment within its first byte. */
+    uint32_t bitnum;
+    /** @brief First pixel written by the segment. */
+    uint32_t out_start;
+    /** @brief Pixel following the last one written by the segment. */
+    uint32_t out_end;
+    /** @brief Result of decoding the segment (GIF_SUCCESS or an error code). */
+    int result;
+} GIF_LZWSegment;
+
+/**
+ * @brief Location and parameters of one frame, as recorded by gif_build_frame_index().
+ *
+ * Holds everything needed to decode and composite the frame without walking the GIF
+ * data from the start.
+ */
+typedef struct {
+    /** @brief Offset in the GIF data of the first LZW sub-block of the frame. */
+    size_t lzw_pos;
+    /** @brief Offset in the GIF data of the local color table, or 0 if the global one is used. */
+    size_t local_palette_pos;
+    /** @brief Number of entries in the local color table (0 if none). */
+    uint16_t local_palette_size;
+    /** @brief X-offset of the frame relative to the canvas. */
+    uint16_t x_off;
+    /** @brief Y-offset of the frame relative to the canvas. */
+    uint16_t y_off;
+    /** @brief Width of the frame. */
+    uint16_t width;
+    /** @brief Height of the frame. */
+    uint16_t height;
+    /** @brief Delay for the frame in milliseconds. */
+    uint16_t delay_ms;
+    /** @brief Packed field from the image descriptor (contains interlacing flag). */
+    uint8_t ucGIFBits;
+    /** @brief Initial LZW code size of the frame. */
+    uint8_t lzw_code_start_size;
+    /** @brief Flag indicating if the frame has transparency. */
+    uint8_t has_transparency;
+    /** @brief Index of the transparent color. */
+    uint8_t transparent_index;
+    /** @brief Disposal method for the frame. */
+    uint8_t disposal_method;
+    /** @brief FNV-1a hash of the frame's descriptor, local palette, LZW data, transparency and disposal (0 outside gif_build_frame_index()). */
+    uint32_t hash;
+} GIF_FrameInfo;
+
+/** @brief Rectangle on the canvas. */
+typedef struct {
+    /** @brief Left edge. */
+    uint16_t x;
+    /** @brief Top edge. */
+    uint16_t y;
+    /** @brief Width; 0 for an empty rectangle. */
+    uint16_t width;
+    /** @brief Height; 0 for an empty rectangle. */
+    uint16_t height;
+} GIF_Rect;
+
+/** @brief Animation-wide properties reported by gif_analyze(). */
+typedef struct {
+    /** @brief Number of frames in one loop of the animation. */
+    int frame_count;
+    /** @brief Union of the rectangles of all frames. */
+    GIF_Rect bounds;
+    /** @brief Union of the rectangles of the frames after the first that can change the canvas. */
+    GIF_Rect changed;
+    /** @brief Duration of one loop in milliseconds, after delay clamping. */
+    uint32_t duration_ms;
+    /** @brief Effective frame rate after delay clamping, in hundredths of frames per second. */
+    uint32_t fps_x100;
+    /** @brief 1 if no frame after the first can change the canvas. */
+    uint8_t is_static;
+} GIF_Analysis;
+
+#ifdef GIF_MODE_TURBO
+/**
+ * @brief Index plane of one frame for gif_decode_frame_planes() and gif_composite_frame().
+ */
+typedef struct {
+    /** @brief Frame to decode, usually an entry of the frame index. */
+    const GIF_FrameInfo *frame;
+    /** @brief Buffer for the palette indices of the frame (`width * height` bytes, plus
+     *  GIF_LZW_COPY_CHUNK bytes for the fast copy path). */
+    uint8_t *indices;
+    /** @brief Size of `indices` in bytes. */
+    size_t indices_size;
+    /** @brief Number of indices decoded, set by gif_decode_frame_planes(). */
+    uint32_t decoded;
+    /** @brief Result of decoding the frame (GIF_SUCCESS or an error code), set by gif_decode_frame_planes(). */
+    int result;
+} GIF_FramePlane;
+
+/** @brief One frame in flight between the stages of a GIF_Pipeline. */
+typedef struct {
+    /** @brief Parameters of the frame. */
+    GIF_FrameInfo frame;
+    /** @brief Index plane of the frame, backed by the pipeline memory. */
+    GIF_FramePlane plane;
+    /** @brief Result of gif_next_frame_plane() for this slot (1, 0 or -1). */
+    int status;
+} GIF_PipelineSlot;
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of decoded index planes.
+ *
+ * The LZW stage pushes frames with gif_pipeline_push() and the compositing stage pops
+ * them with gif_pipeline_pop(). Each counter is written by one stage only and is kept on
+ * its own cache line.
+ */
+typedef struct {
+    /** @brief Slots of the ring, carved out of the caller memory. */
+    GIF_PipelineSlot *slots;
+    /** @brief Number of slots. */
+    uint32_t slot_count;
+    /** @brief Number of frames pushed so far (written by the producer only). */
+    volatile uint32_t head;
+    /** @brief Keeps `head` and `tail` on separate cache lines. */
+    uint8_t padding[GIF_SCRATCH_ALIGN];
+    /** @brief Number of frames popped so far (written by the consumer only). */
+    volatile uint32_t tail;
+} GIF_Pipeline;
+#endif
+
 /**
  * @brief Structure holding the state of the GIF decoder.
  *
@@ -200,15 +553,43 @@ typedef struct {
     /** @brief Pointer to the LZW buffer within the user-provided scratch buffer. */
     uint8_t *scratch_lzw_buffer;
 #ifdef GIF_MODE_TURBO
-    /** @brief Pointer to the LZW dictionary symbols for Turbo mode. */
-    uint8_t *scratch_lzw_dict_symbols;
-    /** @brief Pointer to the LZW dictionary lengths for Turbo mode. */
-    uint8_t *scratch_lzw_dict_lengths;
-    /** @brief Pointer to the LZW pixels suffix buffer for Turbo mode. */
-    uint8_t *scratch_lzw_pixels_suffix;
+    /** @brief Pointer to the packed LZW dictionary for Turbo mode (64-byte aligned). */
+    GIF_LZWEntry *scratch_lzw_dict;
+    /** @brief Pointer to the buffer holding materialized LZW strings for Turbo mode. */
+    uint8_t *scratch_lzw_strings;
+    /** @brief Optional caller-provided index canvas backing the LZW dictionary (see gif_set_index_canvas()). */
+    uint8_t *index_canvas;
+    /** @brief Size of `index_canvas` in bytes. */
+    size_t index_canvas_size;
+    /** @brief Optional parallel-for callback for parallel decoding (see gif_set_parallel_decode()). */
+    GIF_ParallelFor parallel_for;
+    /** @brief User data passed to `parallel_for`. */
+    void *parallel_user_data;
+    /** @brief Number of parallel decoding workers; 0 disables parallel decoding. */
+    int parallel_workers;
+    /** @brief Per-worker LZW dictionaries for parallel decoding (64-byte aligned). */
+    GIF_LZWEntry *parallel_dicts;
+    /** @brief Segment table for parallel decoding. */
+    GIF_LZWSegment *parallel_segments;
+    /** @brief Buffer collecting the LZW data of a frame for parallel decoding. */
+    uint8_t *parallel_stream;
+    /** @brief Size of `parallel_stream` in bytes. */
+    size_t parallel_stream_capacity;
+    /** @brief Number of indices the last frame decoded into `index_canvas`; 0 if another decoder ran. */
+    uint32_t index_canvas_decoded;
+    /** @brief Optional caller memory holding compressed frames for looped playback (see gif_set_frame_cache()). */
+    uint8_t *frame_cache;
+    /** @brief Usable size of `frame_cache`; the frame table grows down from this offset. */
+    size_t frame_cache_size;
+    /** @brief Bytes of compressed frame data at the start of `frame_cache`. */
+    size_t frame_cache_used;
+    /** @brief Number of frames in the frame table of `frame_cache`. */
+    uint32_t frame_cache_frames;
 #else
     /** @brief Pointer to the LZW table for Safe mode. */
     uint16_t *scratch_lzw_table;
+    /** @brief Pointer to the LZW string lengths for Safe mode. */
+    uint16_t *scratch_lzw_lengths;
     /** @brief Pointer to the LZW pixels buffer for Safe mode. */
     uint8_t *scratch_lzw_pixels;
 #endif
@@ -217,13 +598,48 @@ typedef struct {
 
     /** @brief Position in `gif_data` where animation frames start. */
     size_t anim_start_pos;
+    /** @brief Parameters of the last frame rendered by gif_next_frame(). */
+    GIF_FrameInfo last_frame;
+    /** @brief Position after the block terminator of `last_frame`; 0 if there is none. */
+    size_t last_frame_end;
     /** @brief Small internal buffer for reading headers/extensions. */
     uint8_t file_buf[GIF_LZW_CHUNK_SIZE + 32];
 
     /** @brief Callback function for error handling. */
     GIF_ErrorCallback error_callback;
+#ifdef GIF_ENABLE_STATS
+    /** @brief Hot-path event counters (see GIF_Stats). */
+    GIF_Stats stats;
+#endif
 } GIF_Context;
 
+/**
+ * @brief Double-buffered playback state (see gif_player_init()).
+ *
+ * The next frame is decoded into the back buffer by gif_player_prefetch() on a worker
+ * thread while the front buffer is on screen; gif_player_present() flips them.
+ */
+typedef struct {
+    /** @brief Context decoding the animation, used by gif_player_prefetch() only. */
+    GIF_Context *ctx;
+    /** @brief Front and back RGB888 frame buffers. */
+    uint8_t *buffers[2];
+    /** @brief Size of one frame buffer (canvas `width * height * 3` bytes). */
+    size_t frame_size;
+    /** @brief Index of the front buffer in `buffers`. */
+    int front;
+    /** @brief Back buffer state: 0 free for a prefetch, 1 holds the next result. */
+    volatile uint32_t ready;
+    /** @brief gif_next_frame() result of the prefetched frame. */
+    int next_status;
+    /** @brief Delay of the prefetched frame in milliseconds. */
+    int next_delay_ms;
+    /** @brief Set once the pending frame has been counted as late. */
+    int late;
+    /** @brief Number of frames that were not ready when they were due. */
+    uint32_t missed_deadlines;
+} GIF_Player;
+
 // --- API Functions ---
 
 /**
@@ -258,7 +674,9 @@ int gif_get_info(GIF_Context *ctx, int *width, int *height);
  * @brief Decodes and renders the next frame of the GIF.
  *
  * This function decodes the LZW data of the current frame and renders it
- * into the provided buffer in RGB888 format (3 bytes per pixel).
+ * into the provided buffer in RGB888 format (3 bytes per pixel). A frame whose data
+ * repeats the previous frame byte for byte leaves the buffer as it is, since rendering
+ * it again would not change it.
  *
  * @param ctx Pointer to the initialized GIF_Context structure.
  * @param frame_buffer Pointer to a user-provided buffer where the decoded frame
@@ -301,6 +719,274 @@ void gif_close(GIF_Context *ctx);
  */
 void gif_set_error_callback(GIF_Context *ctx, GIF_ErrorCallback callback);
 
+/**
+ * @brief Builds an index of the frames of the GIF without decoding them.
+ *
+ * Walks the GIF data once from the first frame to the trailer, recording where the LZW
+ * data of every frame starts along with its geometry, palette and Graphic Control
+ * Extension parameters. The decoding position of the context is not changed.
+ *
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ * @param frames Array receiving up to `max_frames` entries; may be NULL if `max_frames` is 0.
+ * @param max_frames Capacity of `frames`.
+ * @param frame_count Receives the total number of frames, which may exceed `max_frames`.
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+int gif_build_frame_index(GIF_Context *ctx, GIF_FrameInfo *frames, int max_frames, int *frame_count);
+
+/**
+ * @brief Analyzes the whole animation without decoding it.
+ *
+ * Walks the blocks of the GIF like gif_build_frame_index(). A frame after the first can
+ * change the canvas unless it repeats the previous frame byte for byte (see
+ * gif_next_frame()), so the canvas outside `changed` keeps its content from the first
+ * frame on. Frames are not decoded, so frames that change no pixel in practice still
+ * count as changes. The decoding position of the context is not changed.
+ *
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ * @param analysis Receives the analysis.
+ * @param static_mask Optional mask receiving one byte per GIF_ANALYSIS_TILE square tile of
+ * the canvas, row by row: 1 if the tile never changes after the first frame, 0 otherwise.
+ * @param static_mask_size Size of `static_mask`; at least GIF_ANALYSIS_MASK_SIZE(width, height).
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+int gif_analyze(GIF_Context *ctx, GIF_Analysis *analysis, uint8_t *static_mask, size_t static_mask_size);
+
+#ifdef GIF_ENABLE_STATS
+/**
+ * @brief Clears the hot-path counters of a context (only with GIF_ENABLE_STATS).
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ */
+void gif_reset_stats(GIF_Context *ctx);
+
+/**
+ * @brief Formats the hot-path counters of a context as one line of `key=value` pairs.
+ *
+ * Adds the average LZW string length (indices per data code) to the raw counters.
+ * Only available with GIF_ENABLE_STATS.
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ * @param buffer Receives the NUL-terminated line; may be NULL if `buffer_size` is 0.
+ * @param buffer_size Size of `buffer`.
+ * @return Length of the full line like snprintf(), or a negative error code.
+ */
+int gif_format_stats(const GIF_Context *ctx, char *buffer, size_t buffer_size);
+#endif
+
+/**
+ * @brief Decodes many GIFs on caller-provided worker threads.
+ *
+ * Each of the `workers` tasks owns one decoder scratch buffer for the whole batch and
+ * starts on its own contiguous share of the jobs. Workers that run out steal jobs from
+ * the others, one at a time, through lock-free counters. Results and timings are written
+ * back into each job.
+ *
+ * @param jobs Jobs to run.
+ * @param count Number of jobs.
+ * @param parallel_for Parallel-for callback, or NULL to run the workers in order on the calling thread.
+ * @param user_data User data passed to `parallel_for` and `clock`.
+ * @param workers Number of workers.
+ * @param scratch Scratch buffer of at least GIF_BATCH_SCRATCH_SIZE(workers) bytes.
+ * @param scratch_size Size of the scratch buffer.
+ * @param clock Clock for per-job timings, or NULL.
+ * @return GIF_SUCCESS if the jobs ran (check `result` of each job), or an error code.
+ */
+int gif_decode_batch(GIF_BatchJob *jobs, int count, GIF_ParallelFor parallel_for, void *user_data, int workers,
+                     uint8_t *scratch, size_t scratch_size, GIF_ClockFunc clock);
+
+/**
+ * @brief Sets up double-buffered playback of an initialized context.
+ *
+ * Both frame buffers are cleared. Frames are decoded with gif_next_frame(), so looping
+ * follows the loop count of the GIF. Call gif_player_prefetch() once before the first
+ * gif_player_present().
+ *
+ * @param player Player to initialize.
+ * @param ctx Initialized context; from now on only gif_player_prefetch() may use it.
+ * @param buffers Memory for two frame buffers (canvas `width * height * 3` bytes each).
+ * @param buffers_size Size of `buffers`.
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+int gif_player_init(GIF_Player *player, GIF_Context *ctx, uint8_t *buffers, size_t buffers_size);
+
+/**
+ * @brief Decodes the next frame into the back buffer (worker thread).
+ *
+ * Does nothing while the previous prefetch has not been presented yet, so it can be
+ * scheduled right after every gif_player_present().
+ *
+ * @param player Pointer to the initialized player.
+ * @return The gif_next_frame() result of the frame, or GIF_PLAYER_LATE if the back
+ * buffer is still waiting to be presented.
+ */
+int gif_player_prefetch(GIF_Player *player);
+
+/**
+ * @brief Presents the prefetched frame by flipping the buffers (display thread).
+ *
+ * Call it when the current frame's delay has elapsed. If the prefetch has not finished,
+ * the deadline is missed: `missed_deadlines` is incremented once for the frame and
+ * GIF_PLAYER_LATE is returned, so the caller can retry.
+ *
+ * @param player Pointer to the initialized player.
+ * @param frame Receives the front buffer holding the presented frame.
+ * @param delay_ms Receives the delay of the presented frame in milliseconds.
+ * @return 1 if a frame was presented, 0 at the end of the animation, -1 on error,
+ * GIF_PLAYER_LATE if the frame is not ready.
+ */
+int gif_player_present(GIF_Player *player, uint8_t **frame, int *delay_ms);
+
+#ifdef GIF_MODE_TURBO
+/**
+ * @brief Attaches a caller-provided index canvas to the Turbo decoder.
+ *
+ * Frames whose `width * height` fits in the index canvas are first decoded into it as
+ * palette indices. Dictionary entries then reference strings that were already decoded
+ * there, so every LZW code becomes a single copy and no strings are built in the
+ * scratch buffer. Frames that do not fit fall back to the regular Turbo decoder.
+ *
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ * @param index_canvas Buffer for the palette indices of a frame; `width * height` bytes
+ * of the GIF canvas cover every frame, GIF_LZW_COPY_CHUNK more bytes let every string
+ * copy use the fast over-copying path. NULL detaches the index canvas.
+ * @param index_canvas_size Size of the index canvas in bytes.
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+int gif_set_index_canvas(GIF_Context *ctx, uint8_t *index_canvas, size_t index_canvas_size);
+
+/**
+ * @brief Attaches a frame cache for looped playback (Turbo mode).
+ *
+ * During the first pass over the animation, gif_next_frame() stores the index plane of
+ * every frame decoded through the index canvas (see gif_set_index_canvas()) in `memory`,
+ * PackBits-compressed. When the animation loops, cached frames are expanded from memory
+ * and rendered without running the LZW decoder. If the budget runs out, frames that no
+ * longer fit are decoded normally on every loop while the smaller ones stay cached.
+ *
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ * @param memory Cache memory; each frame takes a small table entry plus its compressed
+ * indices. NULL detaches the cache.
+ * @param memory_size Size of `memory` in bytes.
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+int gif_set_frame_cache(GIF_Context *ctx, uint8_t *memory, size_t memory_size);
+
+/**
+ * @brief Enables parallel decoding of large frames in Turbo mode.
+ *
+ * Every LZW clear code starts an independent segment of the frame. For frames of at least
+ * GIF_PARALLEL_MIN_PIXELS pixels that fit in the index canvas (see gif_set_index_canvas()),
+ * a lengths-only pre-pass locates the clear codes and the pixel offset of each segment,
+ * then the segments are decoded concurrently into the index canvas through
+ * `parallel_for`. The result is identical to serial decoding. Frames without periodic
+ * clear codes, frames whose LZW data does not fit in the scratch buffer, and corrupted
+ * frames are decoded serially.
+ *
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ * @param parallel_for Parallel-for callback, or NULL to run the segment tasks in order on
+ * the calling thread.
+ * @param user_data User data passed to `parallel_for`.
+ * @param workers Number of tasks (and LZW dictionaries) per frame; 0 disables parallel decoding.
+ * @param parallel_scratch Scratch buffer of at least GIF_PARALLEL_SCRATCH_SIZE(workers, 0)
+ * bytes; the remainder holds the LZW data of a frame.
+ * @param parallel_scratch_size Size of the scratch buffer.
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+int gif_set_parallel_decode(GIF_Context *ctx, GIF_ParallelFor parallel_for, void *user_data, int workers,
+                            uint8_t *parallel_scratch, size_t parallel_scratch_size);
+
+/**
+ * @brief Decodes the index planes of several frames concurrently (Turbo mode).
+ *
+ * The LZW data of every frame is independent, so each plane is decoded by one of
+ * `workers` tasks, each with its own dictionary in `worker_scratch`. Only palette indices
+ * are produced; gif_composite_frame() then applies palettes, transparency and disposal in
+ * frame order. The context is only read, so it must not be used for decoding meanwhile.
+ *
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ * @param planes Planes to decode; `decoded` and `result` are set for every entry.
+ * @param count Number of planes.
+ * @param parallel_for Parallel-for callback, or NULL to run the tasks in order on the calling thread.
+ * @param user_data User data passed to `parallel_for`.
+ * @param workers Number of tasks.
+ * @param worker_scratch Scratch buffer of at least `workers * GIF_WORKER_SCRATCH_SIZE` bytes.
+ * @param worker_scratch_size Size of the scratch buffer.
+ * @return GIF_SUCCESS if the tasks ran (check `result` of each plane), or an error code.
+ */
+int gif_decode_frame_planes(GIF_Context *ctx, GIF_FramePlane *planes, int count, GIF_ParallelFor parallel_for,
+                            void *user_data, int workers, uint8_t *worker_scratch, size_t worker_scratch_size);
+
+/**
+ * @brief Renders a decoded index plane into the frame buffer (Turbo mode).
+ *
+ * Planes must be composited in frame order into the same frame buffer, starting with the
+ * first frame, to get the frames gif_next_frame() would produce.
+ *
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ * @param plane Plane decoded by gif_decode_frame_planes().
+ * @param frame_buffer Pointer to the RGB888 frame buffer (canvas width * height * 3 bytes).
+ * @param delay_ms Receives the delay of the frame in milliseconds.
+ * @return 1 if the frame was rendered, -1 on error.
+ */
+int gif_composite_frame(GIF_Context *ctx, const GIF_FramePlane *plane, uint8_t *frame_buffer, int *delay_ms);
+
+/**
+ * @brief Decodes the next frame into an index plane without rendering it (Turbo mode).
+ *
+ * Behaves like gif_next_frame(), including looping, but stops at the palette indices;
+ * gif_composite_frame() renders them.
+ *
+ * @param ctx Pointer to the initialized GIF_Context structure.
+ * @param frame Receives the parameters of the frame; `plane->frame` is set to it.
+ * @param plane Plane whose `indices` receive the frame; `decoded` and `result` are set.
+ * @return 1 if a frame was decoded, 0 if the animation is finished, -1 on error.
+ */
+int gif_next_frame_plane(GIF_Context *ctx, GIF_FrameInfo *frame, GIF_FramePlane *plane);
+
+/**
+ * @brief Sets up a two-stage decoding pipeline in caller memory (Turbo mode).
+ *
+ * One thread runs LZW decoding with gif_pipeline_push() while another composites with
+ * gif_pipeline_pop(), so a frame costs the slower of the two stages instead of both.
+ * Each stage uses its own context: the consumer's can be a copy of the producer's taken
+ * right after gif_init().
+ *
+ * @param pipe Pipeline to initialize.
+ * @param slots Number of frames the ring holds.
+ * @param plane_size Size of the index plane of each slot.
+ * @param memory Caller memory of at least GIF_PIPELINE_MEMORY_SIZE(slots, plane_size) bytes.
+ * @param memory_size Size of `memory`.
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+int gif_pipeline_init(GIF_Pipeline *pipe, int slots, size_t plane_size, uint8_t *memory, size_t memory_size);
+
+/**
+ * @brief Decodes the next frame into a free slot of the pipeline (producer stage).
+ *
+ * Never blocks. The end of the animation and decoding errors travel through the ring,
+ * so the consumer sees them in order.
+ *
+ * @param pipe Pointer to the initialized pipeline.
+ * @param ctx Context of the producer stage.
+ * @return 1 if a frame was pushed, 0 if the end of the animation was pushed, -1 if an
+ * error was pushed, GIF_PIPELINE_BUSY if the ring is full.
+ */
+int gif_pipeline_push(GIF_Pipeline *pipe, GIF_Context *ctx);
+
+/**
+ * @brief Composites the oldest frame of the pipeline and frees its slot (consumer stage).
+ *
+ * Never blocks.
+ *
+ * @param pipe Pointer to the initialized pipeline.
+ * @param ctx Context of the consumer stage.
+ * @param frame_buffer Pointer to the RGB888 frame buffer.
+ * @param delay_ms Receives the delay of the frame in milliseconds.
+ * @return 1 if a frame was rendered, 0 at the end of the animation, -1 on error,
+ * GIF_PIPELINE_BUSY if the ring is empty.
+ */
+int gif_pipeline_pop(GIF_Pipeline *pipe, GIF_Context *ctx, uint8_t *frame_buffer, int *delay_ms);
+#endif
+
 
 #ifdef __cplusplus
 }
@@ -309,6 +995,53 @@ void gif_set_error_callback(GIF_Context *ctx, GIF_ErrorCallback callback);
 // --- Implementation (only if GIF_IMPLEMENTATION is defined) ---
 #ifdef GIF_IMPLEMENTATION
 
+/** @brief Forces inlining so that each call site gets its own specialized copy. */
+#if defined(__GNUC__) || defined(__clang__)
+#define GIF_FORCE_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define GIF_FORCE_INLINE static __forceinline
+#else
+#define GIF_FORCE_INLINE static inline
+#endif
+
+/** @brief Acquire load and release store of a 32-bit counter shared between two threads. */
+#if defined(__GNUC__) || defined(__clang__)
+#define GIF_ATOMIC_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define GIF_ATOMIC_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define GIF_ATOMIC_LOAD_ACQUIRE(p) ((uint32_t)_InterlockedOr((volatile long *)(p), 0))
+#define GIF_ATOMIC_STORE_RELEASE(p, v) ((void)_InterlockedExchange((volatile long *)(p), (long)(v)))
+#else
+// No known atomics: plain volatile accesses, only safe when both stages share one core
+#define GIF_ATOMIC_LOAD_ACQUIRE(p) (*(p))
+#define GIF_ATOMIC_STORE_RELEASE(p, v) (*(p) = (v))
+#endif
+
+/** @brief Adds to a GIF_Stats counter of a context; compiles to nothing without GIF_ENABLE_STATS. */
+#ifdef GIF_ENABLE_STATS
+#include <stdio.h> // For snprintf in gif_format_stats()
+#define GIF_STAT_ADD(ctx, counter, n) ((ctx)->stats.counter += (uint64_t)(n))
+#else
+#define GIF_STAT_ADD(ctx, counter, n) ((void)0)
+#endif
+/** @brief Increments a GIF_Stats counter of a context. */
+#define GIF_STAT_INC(ctx, counter) GIF_STAT_ADD(ctx, counter, 1)
+
+/** @brief Atomically adds 1 to a 32-bit counter and returns its previous value. */
+#if defined(__GNUC__) || defined(__clang__)
+#define GIF_ATOMIC_FETCH_INC(p) __atomic_fetch_add((p), 1u, __ATOMIC_RELAXED)
+#elif defined(_MSC_VER)
+#define GIF_ATOMIC_FETCH_INC(p) ((uint32_t)_InterlockedExchangeAdd((volatile long *)(p), 1))
+#else
+#define GIF_ATOMIC_FETCH_INC(p) ((*(p))++)
+#endif
+
+/** @brief Flag in an LZW string length marking a string made of one repeated byte. */
+#define GIF_LZW_LENGTH_RUN 0x8000u
+/** @brief Mask extracting the string length from a flagged LZW string length. */
+#define GIF_LZW_LENGTH_MASK 0x7FFFu
+
 /**
  * @brief Reports an error by calling the error callback if set.
  * @param ctx Pointer to the GIF context.
@@ -472,17 +1205,25 @@ static int gif_get_more_lzw_data(GIF_Context *ctx) {
         return 1; // End of frame data already reached
     }
 
+    GIF_STAT_INC(ctx, refills);
     // Shift remaining data to the beginning of the buffer
     if (ctx->lzw_read_offset > 0) {
         if (bytes_in_buffer > 0) {
             memmove(ctx->scratch_lzw_buffer, ctx->scratch_lzw_buffer + ctx->lzw_read_offset, (size_t)bytes_in_buffer);
+            GIF_STAT_ADD(ctx, bytes_moved, bytes_in_buffer);
+        } else {
+            bytes_in_buffer = 0;
         }
         ctx->lzw_data_size = bytes_in_buffer;
         ctx->lzw_read_offset = 0;
     }
 
     // Read more blocks until buffer is full or end of frame
-    while (ctx->lzw_data_size < (lzw_buf_capacity - GIF_LZW_CHUNK_SIZE) && ctx->current_pos < ctx->gif_size) {
+    while (ctx->lzw_data_size < (lzw_buf_capacity - GIF_LZW_CHUNK_SIZE)) {
+        if (ctx->current_pos >= ctx->gif_size) { // Missing block terminator, treat as end of frame
+            ctx->lzw_end_of_frame = 1;
+            break;
+        }
         c = gif_read_byte_internal(ctx);
         if (c == 0) { // Block terminator
             ctx->lzw_end_of_frame = 1;
@@ -495,74 +1236,322 @@ static int gif_get_more_lzw_data(GIF_Context *ctx) {
             return 0;
         }
     }
-    return (c != 0 || ctx->lzw_end_of_frame);
+    return 1;
 }
 
 /**
- * @brief LZW decoding helper function for copying bytes (optimized).
- * @param buf Buffer containing LZW data.
- * @param offset Write offset.
- * @param symbols Pointer to the LZW dictionary symbols array.
- * @param lengths Pointer to the LZW dictionary lengths array.
- * @return Length of the copied data. Returns 0 on buffer overflow.
- */
-static int gif_lzw_copy_bytes(uint8_t *buf, int offset, uint32_t *symbols, uint16_t *lengths) {
-    int len = *lengths;
-    uint32_t u32Offset = *symbols;
-    uint8_t *s = &buf[u32Offset & 0x7fffff];
-    uint8_t *d = &buf[offset];
-    uint8_t *pEnd = &d[len];
-
-    // Check for potential buffer overflow before copying
-    if (offset + len > GIF_LZW_BASE_BUF_SIZE + GIF_LZW_TABLE_ENTRIES * 2) { // Max possible size for scratch_lzw_buffer
-        // This indicates a severe decoding issue or corrupted GIF data
-        return 0; // Indicate failure
-    }
-
-    // Optimized copy using larger types if available and aligned
-    while (d + sizeof(uint32_t) <= pEnd && (uintptr_t)s % sizeof(uint32_t) == 0 && (uintptr_t)d % sizeof(uint32_t) == 0) {
-        *(uint32_t *)d = *(uint32_t *)s;
-        s += sizeof(uint32_t);
-        d += sizeof(uint32_t);
-    }
-    while (d < pEnd) {
-        *d++ = *s++;
-    }
-
-    if (u32Offset & 0x800000) { // Check for extended suffix byte
-        d = pEnd;
-        len++;
-        // Check for potential buffer overflow for the added byte
-        if (offset + len > GIF_LZW_BASE_BUF_SIZE + GIF_LZW_TABLE_ENTRIES * 2) {
-            return 0; // Indicate failure
-        }
-        *symbols = (uint32_t)offset;
-        *d = (uint8_t)(u32Offset >> 24);
-        *lengths = (uint16_t)len;
+ * @brief Renders one row of palette indices into the frame buffer.
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the RGB888 frame buffer.
+ * @param y Row within the current frame.
+ * @param src_pixels Palette indices of the row (`frame_width` entries).
+ */
+static void gif_render_row(GIF_Context *ctx, uint8_t *frame_buffer, int y, const uint8_t *src_pixels) {
+    uint8_t *dest_row_start = frame_buffer + ((size_t)ctx->frame_y_off + y) * ctx->canvas_width * 3 + ctx->frame_x_off * 3;
+    uint8_t *palette = ctx->active_palette_colors; // Cache palette pointer
+    uint32_t i;
+
+    GIF_STAT_INC(ctx, rows_rendered);
+    for (i = 0; i < ctx->frame_width; i++) {
+        uint8_t pixel_index = src_pixels[i];
+        if (ctx->has_transparency && pixel_index == ctx->transparent_index) {
+            if (ctx->disposal_method == 2) {
+                memcpy(dest_row_start + i*3, palette + ctx->background_index*3, 3);
+            } else {
+                GIF_STAT_INC(ctx, transparent_skipped);
+            }
+        } else {
+            memcpy(dest_row_start + i*3, palette + pixel_index*3, 3);
+        }
     }
-    return len;
 }
 
 /**
- * @brief Macro for getting the next LZW code from the buffer.
+ * @brief Returns the frame row of the next decoded row and advances the row counter.
+ *
+ * Rows are placed according to the interlacing passes if the frame is interlaced.
  * @param ctx Pointer to the GIF context.
- * @param p Pointer to the current position in the LZW buffer.
- * @param bitnum Current bit offset.
- * @param codesize Current code size.
- * @param sMask Mask for extracting the code.
- * @param code Variable to store the retrieved code.
- * @param ulBits Variable to store the read bits.
+ * @param line_idx Row counter within the current interlacing pass, updated on return.
+ * @param pass Current interlacing pass, updated on return.
+ * @return Row within the frame; `frame_height` or more once all rows are decoded.
  */
-#define GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits) \
-    do { \
-        if (bitnum > (32 - codesize)) { /* Assuming 32-bit ulBits */ \
-            ctx->lzw_read_offset += (bitnum >> 3); \
-            bitnum &= 7; \
-            if (!gif_get_more_lzw_data(ctx)) { /* Ensure more data is available */ \
-                code = eoi_code; /* Indicate end of input if no more data */ \
-                break; \
-            } \
-            p = ctx->scratch_lzw_buffer + ctx->lzw_read_offset; \
+static int gif_next_row_y(GIF_Context *ctx, int *line_idx, int *pass) {
+    static const int interlaced_line_offset[] = {0, 4, 2, 1};
+    static const int interlaced_line_stride[] = {8, 8, 4, 2};
+    int y_draw = *line_idx;
+
+    if (ctx->ucGIFBits & 0x40) { // Interlaced
+        y_draw = interlaced_line_offset[*pass] + *line_idx * interlaced_line_stride[*pass];
+        while (y_draw >= (int)ctx->frame_height && *pass < 3) {
+            (*pass)++;
+            *line_idx = 0;
+            y_draw = interlaced_line_offset[*pass];
+        }
+    }
+    (*line_idx)++;
+    return y_draw;
+}
+
+/**
+ * @brief Renders all completed rows of the line buffer into the frame buffer.
+ *
+ * Pixels beyond the last row of the frame are discarded.
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the RGB888 frame buffer.
+ * @param pixel_idx Number of pixels in `scratch_line_buffer`, updated on return.
+ * @param line_idx Row counter within the current interlacing pass, updated on return.
+ * @param pass Current interlacing pass, updated on return.
+ */
+static void gif_flush_rows(GIF_Context *ctx, uint8_t *frame_buffer, int *pixel_idx, int *line_idx, int *pass) {
+    int consumed = 0;
+
+    while (*pixel_idx - consumed >= (int)ctx->frame_width) {
+        int y_draw = gif_next_row_y(ctx, line_idx, pass);
+        if (y_draw < (int)ctx->frame_height) {
+            gif_render_row(ctx, frame_buffer, y_draw, ctx->scratch_line_buffer + consumed);
+        }
+        consumed += (int)ctx->frame_width;
+    }
+    if (consumed > 0) {
+        GIF_STAT_ADD(ctx, indices, consumed);
+        // Shift remaining pixels to the beginning of the scratch_line_buffer
+        memmove(ctx->scratch_line_buffer, ctx->scratch_line_buffer + consumed, (size_t)(*pixel_idx - consumed));
+        GIF_STAT_ADD(ctx, bytes_moved, *pixel_idx - consumed);
+        *pixel_idx -= consumed;
+    }
+}
+
+#ifdef GIF_MODE_TURBO
+/** @brief Flag in GIF_LZWEntry::offset marking a string that is not materialized yet. */
+#define GIF_LZW_ENTRY_PENDING 0x80000000u
+/** @brief Mask extracting the prefix code from a pending GIF_LZWEntry::offset. */
+#define GIF_LZW_ENTRY_PREFIX_MASK 0xFFFFu
+
+// The dictionary layout relies on GIF_LZWEntry being exactly 8 bytes
+typedef char gif_lzw_entry_size_check[(sizeof(GIF_LZWEntry) == GIF_LZW_DICT_ENTRY_SIZE) ? 1 : -1];
+
+/**
+ * @brief Copies a string in GIF_LZW_COPY_CHUNK-byte steps, rounding its length up.
+ *
+ * Each step is a fixed-size copy that compiles to unaligned wide loads and stores, so
+ * short strings take a single step. Up to GIF_LZW_COPY_CHUNK - 1 bytes past the end
+ * are read and written: both ranges need that much guard padding, and the destination
+ * must start at least GIF_LZW_COPY_CHUNK bytes after the source or not overlap at all.
+ * @param d Destination.
+ * @param s Source.
+ * @param len Number of bytes to copy.
+ */
+static inline void gif_lzw_wild_copy(uint8_t *d, const uint8_t *s, size_t len) {
+    uint8_t *end = d + len;
+    do {
+        memcpy(d, s, GIF_LZW_COPY_CHUNK);
+        d += GIF_LZW_COPY_CHUNK;
+        s += GIF_LZW_COPY_CHUNK;
+    } while (d < end);
+}
+
+/**
+ * @brief Fills a run of one byte in GIF_LZW_COPY_CHUNK-byte steps, rounding its length up.
+ *
+ * Up to GIF_LZW_COPY_CHUNK - 1 bytes past the end are written, so the destination needs
+ * that much guard padding.
+ * @param d Destination.
+ * @param value Byte to repeat.
+ * @param len Number of bytes to fill.
+ */
+static inline void gif_lzw_wild_fill(uint8_t *d, uint8_t value, size_t len) {
+    uint8_t *end = d + len;
+    do {
+        memset(d, value, GIF_LZW_COPY_CHUNK);
+        d += GIF_LZW_COPY_CHUNK;
+    } while (d < end);
+}
+
+/**
+ * @brief Stores a pending dictionary string at the end of the string buffer.
+ *
+ * Succeeds only if the prefix is a run or already materialized and the string fits.
+ * @param dict Pointer to the packed LZW dictionary.
+ * @param strings Pointer to the string buffer.
+ * @param strings_used Number of bytes used in the string buffer, updated on success.
+ * @param entry Pending entry to materialize.
+ * @return 1 if the string was stored, 0 otherwise.
+ */
+static inline int gif_lzw_materialize(GIF_LZWEntry *dict, uint8_t *strings, uint32_t *strings_used, GIF_LZWEntry *entry) {
+    GIF_LZWEntry *prefix = &dict[entry->offset & GIF_LZW_ENTRY_PREFIX_MASK];
+    int prefix_is_run = (prefix->length & GIF_LZW_LENGTH_RUN) != 0;
+    int len = entry->length & GIF_LZW_LENGTH_MASK;
+    uint8_t *s;
+
+    if ((!prefix_is_run && (prefix->offset & GIF_LZW_ENTRY_PENDING)) || *strings_used + (uint32_t)len > GIF_SCRATCH_LZW_STRINGS_SIZE) {
+        return 0;
+    }
+    s = strings + *strings_used;
+    if (prefix_is_run) {
+        gif_lzw_wild_fill(s, prefix->first, (size_t)(len - 1));
+    } else {
+        gif_lzw_wild_copy(s, strings + prefix->offset, (size_t)(len - 1));
+    }
+    s[len - 1] = entry->last;
+    entry->offset = *strings_used;
+    *strings_used += (uint32_t)len;
+    return 1;
+}
+
+/**
+ * @brief Rebuilds a pending dictionary string back-to-front along its prefix chain.
+ * @param dict Pointer to the packed LZW dictionary.
+ * @param strings Pointer to the string buffer.
+ * @param entry Pending entry to rebuild.
+ * @param dest Destination for the string (written exactly, no padding needed).
+ * @return Length of the string.
+ */
+static int gif_lzw_walk_chain(const GIF_LZWEntry *dict, const uint8_t *strings, const GIF_LZWEntry *entry, uint8_t *dest) {
+    int len = entry->length & GIF_LZW_LENGTH_MASK;
+    int pos = len;
+
+    while (!(entry->length & GIF_LZW_LENGTH_RUN) && (entry->offset & GIF_LZW_ENTRY_PENDING)) {
+        dest[--pos] = entry->last;
+        entry = &dict[entry->offset & GIF_LZW_ENTRY_PREFIX_MASK];
+    }
+    // Exact head copy, the tail is already in place
+    if (entry->length & GIF_LZW_LENGTH_RUN) {
+        memset(dest, entry->first, (size_t)pos);
+    } else {
+        memcpy(dest, strings + entry->offset, (size_t)pos);
+    }
+    return len;
+}
+
+/**
+ * @brief LZW decoding helper function for copying bytes (optimized).
+ *
+ * Runs of a single byte are filled directly and never stored. Other new dictionary
+ * entries start out pending (prefix code plus suffix byte). On first use the string is
+ * materialized at the end of the string buffer, so every later use is a single copy.
+ * If the string buffer is full, the string is rebuilt back-to-front along its prefix
+ * chain instead.
+ * @param dict Pointer to the packed LZW dictionary.
+ * @param strings Pointer to the string buffer.
+ * @param strings_used Number of bytes used in the string buffer, updated on materialization.
+ * @param code LZW code whose string is copied.
+ * @param dest Destination for the string, followed by GIF_SCRATCH_LZW_COPY_PAD bytes of padding.
+ * @return Length of the copied data.
+ */
+static int gif_lzw_copy_bytes(GIF_LZWEntry *dict, uint8_t *strings, uint32_t *strings_used, uint16_t code, uint8_t *dest) {
+    GIF_LZWEntry *entry = &dict[code];
+    int len = entry->length & GIF_LZW_LENGTH_MASK;
+
+    if (entry->length & GIF_LZW_LENGTH_RUN) {
+        gif_lzw_wild_fill(dest, entry->first, (size_t)len);
+        return len;
+    }
+    if ((entry->offset & GIF_LZW_ENTRY_PENDING) && !gif_lzw_materialize(dict, strings, strings_used, entry)) {
+        return gif_lzw_walk_chain(dict, strings, entry, dest);
+    }
+    gif_lzw_wild_copy(dest, strings + entry->offset, (size_t)len);
+    return len;
+}
+
+/**
+ * @brief Expands palette indices straight into the frame buffer, row by row.
+ *
+ * Used by the fused engine for opaque, non-interlaced frames, where every index maps to
+ * a palette color and rows arrive in order. Indices beyond the last row are discarded.
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the RGB888 frame buffer.
+ * @param src Palette indices to expand, or NULL to repeat `run_index`.
+ * @param run_index Palette index repeated when `src` is NULL.
+ * @param len Number of indices.
+ * @param x Column within the current frame row, updated on return.
+ * @param y Current frame row, updated on return.
+ */
+static void gif_expand_indices(GIF_Context *ctx, uint8_t *frame_buffer, const uint8_t *src, uint8_t run_index, int len,
+                               uint32_t *x, uint32_t *y) {
+    const uint8_t *palette = ctx->active_palette_colors;
+    const uint8_t *color = palette + run_index * 3;
+
+    while (len > 0 && *y < ctx->frame_height) {
+        uint32_t n = ctx->frame_width - *x;
+        uint8_t *d = frame_buffer + ((size_t)ctx->frame_y_off + *y) * ctx->canvas_width * 3 + ((size_t)ctx->frame_x_off + *x) * 3;
+        uint32_t i;
+
+        if (n > (uint32_t)len) {
+            n = (uint32_t)len;
+        }
+        if (src) {
+            for (i = 0; i < n; i++) {
+                memcpy(d + i * 3, palette + src[i] * 3, 3);
+            }
+            src += n;
+        } else {
+            for (i = 0; i < n; i++) {
+                memcpy(d + i * 3, color, 3);
+            }
+        }
+        len -= (int)n;
+        *x += n;
+        GIF_STAT_ADD(ctx, indices, n);
+        if (*x == ctx->frame_width) {
+            *x = 0;
+            (*y)++;
+            GIF_STAT_INC(ctx, rows_rendered);
+        }
+    }
+}
+#else // GIF_MODE_SAFE
+/**
+ * @brief Writes the string of an LZW code straight into the line buffer (Safe mode).
+ *
+ * The string length is known up front, so the prefix chain is walked once while the
+ * string is written back-to-front at its final position. Runs of a single byte are
+ * filled without walking the chain.
+ * @param table Pointer to the LZW table (prefix code of every entry).
+ * @param pixels Pointer to the LZW pixels buffer (last byte, then first byte of every entry).
+ * @param lengths Pointer to the LZW string lengths (flagged with GIF_LZW_LENGTH_RUN).
+ * @param code LZW code whose string is written.
+ * @param dest Destination for the string, with room for GIF_LZW_MAX_STRING_LEN bytes.
+ * @return Number of bytes written.
+ */
+static int gif_lzw_write_string(const uint16_t *table, const uint8_t *pixels, const uint16_t *lengths,
+                                uint16_t code, uint8_t *dest) {
+    int len = lengths[code] & GIF_LZW_LENGTH_MASK;
+    uint8_t *d = dest + len;
+
+    if (lengths[code] & GIF_LZW_LENGTH_RUN) {
+        memset(dest, pixels[GIF_LZW_TABLE_ENTRIES + code], (size_t)len);
+        return len;
+    }
+
+    while (d > dest) {
+        *--d = pixels[code];
+        code = table[code];
+    }
+    return len;
+}
+#endif // GIF_MODE_TURBO
+
+/**
+ * @brief Macro for getting the next LZW code from the buffer.
+ * @param ctx Pointer to the GIF context.
+ * @param p Pointer to the current position in the LZW buffer.
+ * @param bitnum Current bit offset.
+ * @param codesize Current code size.
+ * @param sMask Mask for extracting the code.
+ * @param code Variable to store the retrieved code.
+ * @param ulBits Variable to store the read bits.
+ */
+#define GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits) \
+    do { \
+        if (bitnum > (32 - codesize)) { /* Assuming 32-bit ulBits */ \
+            ctx->lzw_read_offset += (bitnum >> 3); \
+            bitnum &= 7; \
+            /* Ensure more data is available, indicate end of input otherwise */ \
+            if (!gif_get_more_lzw_data(ctx) || ctx->lzw_read_offset >= ctx->lzw_data_size) { \
+                code = eoi_code; \
+                break; \
+            } \
+            p = ctx->scratch_lzw_buffer + ctx->lzw_read_offset; \
             /* Ensure we don't read past end of buffer when copying ulBits */ \
             if ((size_t)(ctx->lzw_read_offset + sizeof(uint32_t)) > (size_t)ctx->lzw_data_size) { \
                 /* Copy only available bytes and zero out the rest */ \
@@ -575,35 +1564,20 @@ static int gif_lzw_copy_bytes(uint8_t *buf, int offset, uint32_t *symbols, uint1
         } \
         code = (uint16_t)((ulBits >> bitnum) & sMask); \
         bitnum += codesize; \
+        GIF_STAT_INC(ctx, codes); \
     } while(0)
 
 /**
- * @brief Decodes LZW data for a single frame.
+ * @brief Resets the LZW reader for a new frame and loads the first bits.
  * @param ctx Pointer to the GIF context.
- * @param frame_buffer Pointer to the buffer where the frame will be rendered.
+ * @param ulBits Receives the first 32 bits of LZW data.
  * @return GIF_SUCCESS on success, or an error code.
  */
-static int gif_decode_lzw(GIF_Context *restrict ctx, uint8_t *restrict frame_buffer) {
-    int i, bitnum;
-    uint16_t code, oldcode, codesize, nextcode, nextlim;
-    uint16_t clear_code, eoi_code;
-    uint32_t sMask;
-    uint8_t c = 0; // Initialize 'c'
-    uint8_t *p;
-    uint32_t ulBits;
-
-    uint32_t *lzw_symbols = (uint32_t*)ctx->scratch_lzw_dict_symbols;
-    uint16_t *lzw_lengths = (uint16_t*)ctx->scratch_lzw_dict_lengths;
-    uint8_t *lzw_pixels_suffix = (uint8_t*)ctx->scratch_lzw_pixels_suffix;
-
-    uint16_t *lzw_table = (uint16_t*)ctx->scratch_lzw_table;
-    uint8_t *lzw_pixels = (uint8_t*)ctx->scratch_lzw_pixels;
-
-    int current_pixel_idx = 0;
-    int current_line_idx = 0;
-    int interlaced_pass = 0;
-    int interlaced_line_offset[] = {0, 4, 2, 1};
-    int interlaced_line_stride[] = {8, 8, 4, 2};
+static int gif_lzw_begin_frame(GIF_Context *ctx, uint32_t *ulBits) {
+    if (ctx->lzw_code_start_size < 2 || ctx->lzw_code_start_size > 8) {
+        gif_report_error(ctx, GIF_ERROR_DECODE, "Invalid LZW minimum code size.");
+        return GIF_ERROR_DECODE;
+    }
 
     ctx->lzw_read_offset = 0;
     ctx->lzw_data_size = 0;
@@ -613,237 +1587,1421 @@ static int gif_decode_lzw(GIF_Context *restrict ctx, uint8_t *restrict frame_buf
         return GIF_ERROR_EARLY_EOF;
     }
 
-    p = ctx->scratch_lzw_buffer;
     // Safely copy initial 4 bytes for ulBits, handling potential buffer end
     if ((size_t)(ctx->lzw_read_offset + sizeof(uint32_t)) > (size_t)ctx->lzw_data_size) {
         size_t bytes_avail = (size_t)ctx->lzw_data_size - (size_t)ctx->lzw_read_offset;
-        ulBits = 0;
-        if (bytes_avail > 0) memcpy(&ulBits, p, bytes_avail);
+        *ulBits = 0;
+        if (bytes_avail > 0) memcpy(ulBits, ctx->scratch_lzw_buffer, bytes_avail);
     } else {
-        memcpy(&ulBits, p, sizeof(uint32_t));
+        memcpy(ulBits, ctx->scratch_lzw_buffer, sizeof(uint32_t));
     }
+    return GIF_SUCCESS;
+}
 
+#ifdef GIF_MODE_TURBO
+/**
+ * @brief Copies the string of an LZW code within the index canvas (Turbo mode).
+ * @param dict Pointer to the LZW dictionary (positions in the index canvas).
+ * @param code LZW code whose string is copied.
+ * @param clear_code Clear code of the frame; codes below it are single bytes.
+ * @param out Pointer to the index canvas.
+ * @param out_pos Write position in the index canvas.
+ * @param out_size Number of indices in the frame; the string is cut off there.
+ * @param out_capacity Size of the index canvas; copies use the over-copying path while
+ * GIF_LZW_COPY_CHUNK bytes of it remain after the string.
+ * @return Number of indices written.
+ */
+static uint32_t gif_lzw_copy_canvas(const GIF_LZWEntry *dict, uint16_t code, uint16_t clear_code,
+                                    uint8_t *out, uint32_t out_pos, uint32_t out_size, size_t out_capacity) {
+    uint32_t len = dict[code].length & GIF_LZW_LENGTH_MASK;
 
-    clear_code = 1 << ctx->lzw_code_start_size;
-    eoi_code = clear_code + 1;
+    if (len > out_size - out_pos) {
+        len = out_size - out_pos; // Discard pixels beyond the end of the frame
+    }
+    if (code < clear_code) {
+        out[out_pos] = (uint8_t)code;
+    } else if (dict[code].length & GIF_LZW_LENGTH_RUN) {
+        if ((size_t)out_pos + len + GIF_LZW_COPY_CHUNK <= out_capacity) {
+            gif_lzw_wild_fill(out + out_pos, dict[code].first, len);
+        } else {
+            memset(out + out_pos, dict[code].first, len);
+        }
+    } else {
+        const uint8_t *s = out + dict[code].offset;
+        uint8_t *d = out + out_pos;
+        if (d - s >= GIF_LZW_COPY_CHUNK && (size_t)out_pos + len + GIF_LZW_COPY_CHUNK <= out_capacity) {
+            gif_lzw_wild_copy(d, s, len);
+        } else if (s + len > d) { // K, K, K sequence: the string overlaps its own output
+            for (uint32_t j = 0; j < len; j++) {
+                d[j] = s[j];
+            }
+        } else {
+            memcpy(d, s, len);
+        }
+    }
+    return len;
+}
+
+/** @brief Output range of an index plane decode (whole frame, or one parallel segment). */
+typedef struct {
+    /** @brief Pointer to the index plane. */
+    uint8_t *out;
+    /** @brief Write position, updated on return. */
+    uint32_t out_pos;
+    /** @brief End of the output range; strings are cut off there. */
+    uint32_t out_size;
+    /** @brief Writable size of the index plane (see gif_lzw_copy_canvas()). */
+    size_t out_capacity;
+    /** @brief Bit offset of the first code within the first byte of LZW data. */
+    int bitnum;
+} GIF_LZWPlane;
+
+/**
+ * @brief Decodes LZW data into an index plane (Turbo mode).
+ *
+ * Every dictionary string already exists in the indices decoded so far, so an entry is
+ * just its position and length in the index plane.
+ * @param ctx Pointer to the GIF context.
+ * @param plane Output range, updated on return.
+ * @param ulBits First 32 bits of LZW data, as loaded by gif_lzw_begin_frame().
+ * @param code_start_size Initial LZW code size of the frame (a constant in each instance).
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+GIF_FORCE_INLINE int gif_lzw_decode_plane(GIF_Context *restrict ctx, GIF_LZWPlane *plane, uint32_t ulBits,
+                                          const int code_start_size) {
+    int i, bitnum = plane->bitnum;
+    uint16_t code, oldcode, codesize, nextcode, nextlim;
+    const uint16_t clear_code = (uint16_t)(1 << code_start_size);
+    const uint16_t eoi_code = clear_code + 1;
+    uint32_t sMask;
+    uint8_t *p = ctx->scratch_lzw_buffer;
+
+    GIF_LZWEntry *lzw_dict = ctx->scratch_lzw_dict;
+    uint8_t *out = plane->out;
+    uint32_t out_size = plane->out_size;
+    uint32_t out_pos = plane->out_pos, old_pos = 0;
 
-#ifdef GIF_MODE_TURBO
     for (i = 0; i < clear_code; i++) {
-        lzw_symbols[i] = (uint32_t)(ctx->scratch_lzw_pixels_suffix - ctx->scratch_lzw_buffer) + (uint32_t)i;
-        lzw_lengths[i] = 1;
-        lzw_pixels_suffix[i] = (uint8_t)i;
+        lzw_dict[i].offset = 0; // Roots are emitted from `first`, they have no position
+        lzw_dict[i].length = 1 | GIF_LZW_LENGTH_RUN;
+        lzw_dict[i].first = lzw_dict[i].last = (uint8_t)i;
     }
-init_codetable_turbo:
-    codesize = ctx->lzw_code_start_size + 1;
+init_codetable_canvas:
+    codesize = code_start_size + 1;
     sMask = (1 << codesize) - 1;
     nextcode = eoi_code + 1;
     nextlim = (1 << codesize);
-    bitnum = 0;
 
     GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
     if (code == clear_code) {
+        GIF_STAT_INC(ctx, clear_codes);
         GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
     }
     if (code == eoi_code) { // Handle immediate EOI after clear code
+        plane->out_pos = out_pos;
         return GIF_SUCCESS;
     }
-    if (code >= GIF_LZW_TABLE_ENTRIES || lzw_lengths[code] == 0) {
+    if (code >= clear_code) {
         gif_report_error(ctx, GIF_ERROR_DECODE, "Invalid initial LZW code in Turbo mode.");
         return GIF_ERROR_DECODE;
     }
-    memcpy(ctx->scratch_line_buffer + current_pixel_idx, ctx->scratch_lzw_buffer + (lzw_symbols[code] & 0x7fffff), lzw_lengths[code]);
-    current_pixel_idx += lzw_lengths[code];
+    old_pos = out_pos;
+    out[out_pos++] = (uint8_t)code;
 
     oldcode = code;
     GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
 
-    while (code != eoi_code) {
+    while (code != eoi_code && out_pos < out_size) {
         if (code == clear_code) {
-            goto init_codetable_turbo;
+            GIF_STAT_INC(ctx, clear_codes);
+            goto init_codetable_canvas;
         }
         // Check if code is valid before attempting to use it
-        if (code >= GIF_LZW_TABLE_ENTRIES) {
+        if (code > nextcode) {
              gif_report_error(ctx, GIF_ERROR_DECODE, "LZW code out of dictionary bounds.");
              return GIF_ERROR_DECODE;
         }
 
-        int len_copied;
         if (nextcode < GIF_LZW_TABLE_ENTRIES) {
-            if (code != nextcode) {
-                len_copied = gif_lzw_copy_bytes(ctx->scratch_lzw_buffer, current_pixel_idx, &lzw_symbols[code], &lzw_lengths[code]);
-                if (len_copied == 0) { gif_report_error(ctx, GIF_ERROR_DECODE, "LZW copy failed (buffer overflow)."); return GIF_ERROR_DECODE; }
-                lzw_symbols[nextcode] = (lzw_symbols[oldcode] | 0x800000 | ((uint32_t)ctx->scratch_lzw_buffer[current_pixel_idx] << 24));
-                lzw_lengths[nextcode] = lzw_lengths[oldcode];
-                current_pixel_idx += len_copied;
-            } else { // Handle K, K, K sequence
-                len_copied = gif_lzw_copy_bytes(ctx->scratch_lzw_buffer, current_pixel_idx, &lzw_symbols[oldcode], &lzw_lengths[oldcode]);
-                if (len_copied == 0) { gif_report_error(ctx, GIF_ERROR_DECODE, "LZW copy failed (buffer overflow)."); return GIF_ERROR_DECODE; }
-                lzw_lengths[nextcode] = (uint16_t)(len_copied + 1);
-                lzw_symbols[nextcode] = (uint32_t)current_pixel_idx;
-                c = ctx->scratch_lzw_buffer[current_pixel_idx];
-                current_pixel_idx += len_copied;
-                ctx->scratch_lzw_buffer[current_pixel_idx++] = c;
+            // The string of oldcode is immediately followed by the first byte of code in the output
+            GIF_LZWEntry *entry = &lzw_dict[nextcode];
+            uint16_t prev_length = lzw_dict[oldcode].length;
+            entry->offset = old_pos;
+            entry->first = lzw_dict[oldcode].first;
+            // Still a run if the appended byte repeats the run
+            if ((code == nextcode ? entry->first : lzw_dict[code].first) != entry->first) {
+                prev_length &= GIF_LZW_LENGTH_MASK;
+            }
+            entry->length = (uint16_t)(prev_length + 1);
+            nextcode++;
+            if (nextcode >= nextlim && codesize < GIF_MAX_CODE_SIZE) {
+                codesize++;
+                nextlim <<= 1;
+                sMask = (sMask << 1) | 1;
             }
-        } else { // Dictionary full, but code is valid
-            len_copied = gif_lzw_copy_bytes(ctx->scratch_lzw_buffer, current_pixel_idx, &lzw_symbols[code], &lzw_lengths[code]);
-            if (len_copied == 0) { gif_report_error(ctx, GIF_ERROR_DECODE, "LZW copy failed (buffer overflow)."); return GIF_ERROR_DECODE; }
-            current_pixel_idx += len_copied;
-        }
-        nextcode++;
-        if (nextcode >= nextlim && codesize < GIF_MAX_CODE_SIZE) {
-            codesize++;
-            nextlim <<= 1;
-            sMask = (sMask << 1) | 1;
         }
 
-        // Render pixels to frame buffer as lines are completed
-        while (current_pixel_idx >= ctx->frame_width) {
-            int y_draw = current_line_idx;
-            if (ctx->ucGIFBits & 0x40) { // Interlaced
-                y_draw = interlaced_line_offset[interlaced_pass] + current_line_idx * interlaced_line_stride[interlaced_pass];
-                while (y_draw >= ctx->frame_height && interlaced_pass < 3) {
-                    interlaced_pass++;
-                    current_line_idx = 0;
-                    y_draw = interlaced_line_offset[interlaced_pass] + current_line_idx * interlaced_line_stride[interlaced_pass];
-                }
-                if (y_draw >= ctx->frame_height) {
-                    gif_report_error(ctx, GIF_ERROR_DECODE, "Interlaced GIF decoding error: line out of bounds.");
-                    return GIF_ERROR_DECODE;
-                }
-            }
+        old_pos = out_pos;
+        out_pos += gif_lzw_copy_canvas(lzw_dict, code, clear_code, out, out_pos, out_size, plane->out_capacity);
 
-            uint8_t *dest_row_start = frame_buffer + (ctx->frame_y_off + y_draw) * ctx->canvas_width * 3 + ctx->frame_x_off * 3;
-            uint8_t *src_pixels = ctx->scratch_line_buffer;
-            uint8_t *palette = ctx->active_palette_colors; // Cache palette pointer
+        oldcode = code;
+        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
 
-            for (i = 0; i < ctx->frame_width; i++) {
-                uint8_t pixel_index = src_pixels[i];
-                if (ctx->has_transparency && pixel_index == ctx->transparent_index) {
-                    if (ctx->disposal_method == 2) {
-                        memcpy(dest_row_start + i*3, palette + ctx->background_index*3, 3);
-                    }
-                } else {
-                    memcpy(dest_row_start + i*3, palette + pixel_index*3, 3);
-                }
+        if (nextcode >= GIF_LZW_TABLE_ENTRIES) {
+            // Dictionary is frozen until the next clear code: fixed-size codes that are always valid, no inserts
+            GIF_STAT_INC(ctx, dictionary_full);
+            while (code != eoi_code && code != clear_code && out_pos < out_size) {
+                out_pos += gif_lzw_copy_canvas(lzw_dict, code, clear_code, out, out_pos, out_size, plane->out_capacity);
+                GET_LZW_CODE(ctx, p, bitnum, GIF_MAX_CODE_SIZE, (GIF_LZW_TABLE_ENTRIES - 1), code, ulBits);
             }
-            // Shift remaining pixels to the beginning of the scratch_line_buffer
-            memmove(ctx->scratch_line_buffer, ctx->scratch_line_buffer + ctx->frame_width, (size_t)(current_pixel_idx - ctx->frame_width));
-            current_pixel_idx -= ctx->frame_width;
-            current_line_idx++;
         }
-        oldcode = code;
-        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
     }
-#else // GIF_MODE_SAFE
+
+    plane->out_pos = out_pos;
+    return GIF_SUCCESS;
+}
+
+/**
+ * @brief Renders the complete rows of an index plane into the frame buffer.
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the RGB888 frame buffer.
+ * @param indices Palette indices of the frame, in decoding order.
+ * @param count Number of decoded indices.
+ */
+static void gif_render_plane(GIF_Context *ctx, uint8_t *frame_buffer, const uint8_t *indices, uint32_t count) {
+    int line_idx = 0, pass = 0;
+
+    for (uint32_t row = 0; row < count / ctx->frame_width; row++) {
+        int y_draw = gif_next_row_y(ctx, &line_idx, &pass);
+        if (y_draw < (int)ctx->frame_height) {
+            gif_render_row(ctx, frame_buffer, y_draw, indices + row * ctx->frame_width);
+        }
+    }
+}
+
+/**
+ * @brief Decodes LZW data for a single frame into the index canvas (Turbo mode).
+ *
+ * The rows are rendered once the whole frame is decoded.
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the buffer where the frame will be rendered.
+ * @param ulBits First 32 bits of LZW data, as loaded by gif_lzw_begin_frame().
+ * @param code_start_size Initial LZW code size of the frame (a constant in each instance).
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+GIF_FORCE_INLINE int gif_decode_lzw_canvas(GIF_Context *restrict ctx, uint8_t *restrict frame_buffer, uint32_t ulBits,
+                                           const int code_start_size) {
+    GIF_LZWPlane plane;
+    int result;
+
+    plane.out = ctx->index_canvas;
+    plane.out_pos = 0;
+    plane.out_size = ctx->frame_width * ctx->frame_height;
+    plane.out_capacity = ctx->index_canvas_size;
+    plane.bitnum = 0;
+    result = gif_lzw_decode_plane(ctx, &plane, ulBits, code_start_size);
+    if (result == GIF_SUCCESS) {
+        GIF_STAT_ADD(ctx, indices, plane.out_pos);
+        gif_render_plane(ctx, frame_buffer, plane.out, plane.out_pos);
+        ctx->index_canvas_decoded = plane.out_pos;
+    }
+    return result;
+}
+
+/**
+ * @brief Decodes LZW data for a single frame through the string buffer (Turbo mode).
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the buffer where the frame will be rendered.
+ * @param ulBits First 32 bits of LZW data, as loaded by gif_lzw_begin_frame().
+ * @param code_start_size Initial LZW code size of the frame (a constant in each instance).
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+GIF_FORCE_INLINE int gif_decode_lzw_turbo(GIF_Context *restrict ctx, uint8_t *restrict frame_buffer, uint32_t ulBits,
+                                          const int code_start_size) {
+    int i, bitnum = 0;
+    uint16_t code, oldcode, codesize, nextcode, nextlim;
+    const uint16_t clear_code = (uint16_t)(1 << code_start_size);
+    const uint16_t eoi_code = clear_code + 1;
+    uint32_t sMask;
+    uint8_t *p = ctx->scratch_lzw_buffer;
+
+    GIF_LZWEntry *lzw_dict = ctx->scratch_lzw_dict;
+    uint8_t *lzw_strings = ctx->scratch_lzw_strings;
+    uint32_t strings_used;
+
+    int current_pixel_idx = 0;
+    int current_line_idx = 0;
+    int interlaced_pass = 0;
+
     for (i = 0; i < clear_code; i++) {
-        lzw_pixels[i] = lzw_pixels[GIF_LZW_TABLE_ENTRIES + i] = (uint8_t)i;
-        lzw_table[i] = 0xFFFF; // LINK_END equivalent
+        lzw_dict[i].offset = 0; // Roots are runs, they are never read from the string buffer
+        lzw_dict[i].length = 1 | GIF_LZW_LENGTH_RUN;
+        lzw_dict[i].first = lzw_dict[i].last = (uint8_t)i;
     }
-init_codetable_safe:
-    codesize = ctx->lzw_code_start_size + 1;
+init_codetable_turbo:
+    codesize = code_start_size + 1;
     sMask = (1 << codesize) - 1;
     nextcode = eoi_code + 1;
     nextlim = (1 << codesize);
-    bitnum = 0;
-    memset(&lzw_table[clear_code], 0xFF, sizeof(uint16_t) * (GIF_LZW_TABLE_ENTRIES - clear_code)); // LINK_UNUSED equivalent
+    strings_used = 0;
 
     GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
     if (code == clear_code) {
+        GIF_STAT_INC(ctx, clear_codes);
         GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
     }
     if (code == eoi_code) { // Handle immediate EOI after clear code
         return GIF_SUCCESS;
     }
-    if (code >= GIF_LZW_TABLE_ENTRIES) {
-        gif_report_error(ctx, GIF_ERROR_DECODE, "Invalid initial LZW code in Safe mode.");
+    if (code >= clear_code) {
+        gif_report_error(ctx, GIF_ERROR_DECODE, "Invalid initial LZW code in Turbo mode.");
         return GIF_ERROR_DECODE;
     }
-    c = oldcode = code;
-    
-    uint8_t temp_line_buf[GIF_MAX_WIDTH];
-    int temp_idx = GIF_MAX_WIDTH;
-    uint16_t current_lzw_code = code;
-    while(current_lzw_code != 0xFFFF && temp_idx > 0) {
-        temp_line_buf[--temp_idx] = lzw_pixels[current_lzw_code];
-        current_lzw_code = lzw_table[current_lzw_code];
-    }
-    memcpy(ctx->scratch_line_buffer + current_pixel_idx, temp_line_buf + temp_idx, (size_t)(GIF_MAX_WIDTH - temp_idx));
-    current_pixel_idx += (GIF_MAX_WIDTH - temp_idx);
+    current_pixel_idx += gif_lzw_copy_bytes(lzw_dict, lzw_strings, &strings_used, code, ctx->scratch_line_buffer + current_pixel_idx);
+    gif_flush_rows(ctx, frame_buffer, &current_pixel_idx, &current_line_idx, &interlaced_pass);
 
+    oldcode = code;
+    GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
 
     while (code != eoi_code) {
-        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
         if (code == clear_code) {
-            goto init_codetable_safe;
+            GIF_STAT_INC(ctx, clear_codes);
+            goto init_codetable_turbo;
         }
         // Check if code is valid before attempting to use it
-        if (code >= GIF_LZW_TABLE_ENTRIES) {
+        if (code > nextcode) {
              gif_report_error(ctx, GIF_ERROR_DECODE, "LZW code out of dictionary bounds.");
              return GIF_ERROR_DECODE;
         }
 
-        temp_idx = GIF_MAX_WIDTH;
-        current_lzw_code = code;
-        while(current_lzw_code != 0xFFFF && temp_idx > 0) {
-            temp_line_buf[--temp_idx] = lzw_pixels[current_lzw_code];
-            current_lzw_code = lzw_table[current_lzw_code];
-        }
-        int pixels_to_copy = GIF_MAX_WIDTH - temp_idx;
-        memcpy(ctx->scratch_line_buffer + current_pixel_idx, temp_line_buf + temp_idx, (size_t)pixels_to_copy);
-        current_pixel_idx += pixels_to_copy;
-
         if (nextcode < GIF_LZW_TABLE_ENTRIES) {
-            lzw_table[nextcode] = oldcode;
-            lzw_pixels[nextcode] = c;
-            lzw_pixels[GIF_LZW_TABLE_ENTRIES + nextcode] = c = lzw_pixels[code];
-        }
-        nextcode++;
-        if (nextcode >= nextlim && codesize < GIF_MAX_CODE_SIZE) {
-            codesize++;
-            nextlim <<= 1;
-            sMask = nextlim - 1;
+            // New entry: string of oldcode followed by the first byte of code (K, K, K sequence if code == nextcode)
+            GIF_LZWEntry *entry = &lzw_dict[nextcode];
+            uint16_t prev_length = lzw_dict[oldcode].length;
+            entry->offset = oldcode | GIF_LZW_ENTRY_PENDING;
+            entry->first = lzw_dict[oldcode].first;
+            entry->last = (code == nextcode) ? entry->first : lzw_dict[code].first;
+            if (entry->last != entry->first) { // Still a run if the appended byte repeats the run
+                prev_length &= GIF_LZW_LENGTH_MASK;
+            }
+            entry->length = (uint16_t)(prev_length + 1);
+            nextcode++;
+            if (nextcode >= nextlim && codesize < GIF_MAX_CODE_SIZE) {
+                codesize++;
+                nextlim <<= 1;
+                sMask = (sMask << 1) | 1;
+            }
         }
+        current_pixel_idx += gif_lzw_copy_bytes(lzw_dict, lzw_strings, &strings_used, code, ctx->scratch_line_buffer + current_pixel_idx);
 
         // Render pixels to frame buffer as lines are completed
-        while (current_pixel_idx >= ctx->frame_width) {
-            int y_draw = current_line_idx;
-            if (ctx->ucGIFBits & 0x40) {
-                y_draw = interlaced_line_offset[interlaced_pass] + current_line_idx * interlaced_line_stride[interlaced_pass];
-                while (y_draw >= ctx->frame_height && interlaced_pass < 3) {
-                    interlaced_pass++;
-                    current_line_idx = 0;
-                    y_draw = interlaced_line_offset[interlaced_pass] + current_line_idx * interlaced_line_stride[interlaced_pass];
-                }
-                if (y_draw >= ctx->frame_height) {
-                    gif_report_error(ctx, GIF_ERROR_DECODE, "Interlaced GIF decoding error: line out of bounds.");
-                    return GIF_ERROR_DECODE;
-                }
+        gif_flush_rows(ctx, frame_buffer, &current_pixel_idx, &current_line_idx, &interlaced_pass);
+        oldcode = code;
+        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+
+        if (nextcode >= GIF_LZW_TABLE_ENTRIES) {
+            // Dictionary is frozen until the next clear code: fixed-size codes that are always valid, no inserts
+            GIF_STAT_INC(ctx, dictionary_full);
+            while (code != eoi_code && code != clear_code) {
+                current_pixel_idx += gif_lzw_copy_bytes(lzw_dict, lzw_strings, &strings_used, code, ctx->scratch_line_buffer + current_pixel_idx);
+                gif_flush_rows(ctx, frame_buffer, &current_pixel_idx, &current_line_idx, &interlaced_pass);
+                GET_LZW_CODE(ctx, p, bitnum, GIF_MAX_CODE_SIZE, (GIF_LZW_TABLE_ENTRIES - 1), code, ulBits);
             }
+        }
+    }
+
+    return GIF_SUCCESS;
+}
+/**
+ * @brief Expands the string of an LZW code through the palette into the frame buffer.
+ *
+ * Materialized strings are read in place from the string buffer; pending strings that
+ * cannot be materialized are rebuilt in `scratch_line_buffer` first.
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the RGB888 frame buffer.
+ * @param dict Pointer to the packed LZW dictionary.
+ * @param strings Pointer to the string buffer.
+ * @param strings_used Number of bytes used in the string buffer, updated on materialization.
+ * @param code LZW code whose string is expanded.
+ * @param x Column within the current frame row, updated on return.
+ * @param y Current frame row, updated on return.
+ */
+static inline void gif_lzw_expand_code(GIF_Context *ctx, uint8_t *frame_buffer, GIF_LZWEntry *dict, uint8_t *strings,
+                                       uint32_t *strings_used, uint16_t code, uint32_t *x, uint32_t *y) {
+    GIF_LZWEntry *entry = &dict[code];
+    int len = entry->length & GIF_LZW_LENGTH_MASK;
+
+    if (entry->length & GIF_LZW_LENGTH_RUN) {
+        gif_expand_indices(ctx, frame_buffer, NULL, entry->first, len, x, y);
+    } else if ((entry->offset & GIF_LZW_ENTRY_PENDING) && !gif_lzw_materialize(dict, strings, strings_used, entry)) {
+        gif_lzw_walk_chain(dict, strings, entry, ctx->scratch_line_buffer);
+        gif_expand_indices(ctx, frame_buffer, ctx->scratch_line_buffer, 0, len, x, y);
+    } else {
+        gif_expand_indices(ctx, frame_buffer, strings + entry->offset, 0, len, x, y);
+    }
+}
+
+/**
+ * @brief Decodes LZW data for a single opaque, non-interlaced frame (Turbo mode).
+ *
+ * Each emitted string is expanded through the palette straight into its frame row, so
+ * indices never pass through the line buffer. Frames with transparency or interlacing
+ * use gif_decode_lzw_turbo() instead.
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the buffer where the frame will be rendered.
+ * @param ulBits First 32 bits of LZW data, as loaded by gif_lzw_begin_frame().
+ * @param code_start_size Initial LZW code size of the frame (a constant in each instance).
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+GIF_FORCE_INLINE int gif_decode_lzw_fused(GIF_Context *restrict ctx, uint8_t *restrict frame_buffer, uint32_t ulBits,
+                                          const int code_start_size) {
+    int i, bitnum = 0;
+    uint16_t code, oldcode, codesize, nextcode, nextlim;
+    const uint16_t clear_code = (uint16_t)(1 << code_start_size);
+    const uint16_t eoi_code = clear_code + 1;
+    uint32_t sMask;
+    uint8_t *p = ctx->scratch_lzw_buffer;
+
+    GIF_LZWEntry *lzw_dict = ctx->scratch_lzw_dict;
+    uint8_t *lzw_strings = ctx->scratch_lzw_strings;
+    uint32_t strings_used;
+
+    uint32_t x = 0, y = 0;
+
+    for (i = 0; i < clear_code; i++) {
+        lzw_dict[i].offset = 0; // Roots are runs, they are never read from the string buffer
+        lzw_dict[i].length = 1 | GIF_LZW_LENGTH_RUN;
+        lzw_dict[i].first = lzw_dict[i].last = (uint8_t)i;
+    }
+init_codetable_fused:
+    codesize = code_start_size + 1;
+    sMask = (1 << codesize) - 1;
+    nextcode = eoi_code + 1;
+    nextlim = (1 << codesize);
+    strings_used = 0;
+
+    GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+    if (code == clear_code) {
+        GIF_STAT_INC(ctx, clear_codes);
+        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+    }
+    if (code == eoi_code) { // Handle immediate EOI after clear code
+        return GIF_SUCCESS;
+    }
+    if (code >= clear_code) {
+        gif_report_error(ctx, GIF_ERROR_DECODE, "Invalid initial LZW code in Turbo mode.");
+        return GIF_ERROR_DECODE;
+    }
+    gif_lzw_expand_code(ctx, frame_buffer, lzw_dict, lzw_strings, &strings_used, code, &x, &y);
 
-            uint8_t *dest_row_start = frame_buffer + (ctx->frame_y_off + y_draw) * ctx->canvas_width * 3 + ctx->frame_x_off * 3;
-            uint8_t *src_pixels = ctx->scratch_line_buffer;
-            uint8_t *palette = ctx->active_palette_colors; // Cache palette pointer
+    oldcode = code;
+    GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+
+    while (code != eoi_code) {
+        if (code == clear_code) {
+            GIF_STAT_INC(ctx, clear_codes);
+            goto init_codetable_fused;
+        }
+        // Check if code is valid before attempting to use it
+        if (code > nextcode) {
+             gif_report_error(ctx, GIF_ERROR_DECODE, "LZW code out of dictionary bounds.");
+             return GIF_ERROR_DECODE;
+        }
+
+        if (nextcode < GIF_LZW_TABLE_ENTRIES) {
+            // New entry: string of oldcode followed by the first byte of code (K, K, K sequence if code == nextcode)
+            GIF_LZWEntry *entry = &lzw_dict[nextcode];
+            uint16_t prev_length = lzw_dict[oldcode].length;
+            entry->offset = oldcode | GIF_LZW_ENTRY_PENDING;
+            entry->first = lzw_dict[oldcode].first;
+            entry->last = (code == nextcode) ? entry->first : lzw_dict[code].first;
+            if (entry->last != entry->first) { // Still a run if the appended byte repeats the run
+                prev_length &= GIF_LZW_LENGTH_MASK;
+            }
+            entry->length = (uint16_t)(prev_length + 1);
+            nextcode++;
+            if (nextcode >= nextlim && codesize < GIF_MAX_CODE_SIZE) {
+                codesize++;
+                nextlim <<= 1;
+                sMask = (sMask << 1) | 1;
+            }
+        }
+        gif_lzw_expand_code(ctx, frame_buffer, lzw_dict, lzw_strings, &strings_used, code, &x, &y);
+
+        oldcode = code;
+        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+
+        if (nextcode >= GIF_LZW_TABLE_ENTRIES) {
+            // Dictionary is frozen until the next clear code: fixed-size codes that are always valid, no inserts
+            GIF_STAT_INC(ctx, dictionary_full);
+            while (code != eoi_code && code != clear_code) {
+                gif_lzw_expand_code(ctx, frame_buffer, lzw_dict, lzw_strings, &strings_used, code, &x, &y);
+                GET_LZW_CODE(ctx, p, bitnum, GIF_MAX_CODE_SIZE, (GIF_LZW_TABLE_ENTRIES - 1), code, ulBits);
+            }
+        }
+    }
+
+    return GIF_SUCCESS;
+}
+#else // GIF_MODE_SAFE
+/**
+ * @brief Decodes LZW data for a single frame by walking prefix chains (Safe mode).
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the buffer where the frame will be rendered.
+ * @param ulBits First 32 bits of LZW data, as loaded by gif_lzw_begin_frame().
+ * @param code_start_size Initial LZW code size of the frame (a constant in each instance).
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+GIF_FORCE_INLINE int gif_decode_lzw_safe(GIF_Context *restrict ctx, uint8_t *restrict frame_buffer, uint32_t ulBits,
+                                         const int code_start_size) {
+    int i, bitnum = 0;
+    uint16_t code, oldcode, codesize, nextcode, nextlim;
+    const uint16_t clear_code = (uint16_t)(1 << code_start_size);
+    const uint16_t eoi_code = clear_code + 1;
+    uint32_t sMask;
+    uint8_t *p = ctx->scratch_lzw_buffer;
+
+    uint16_t *lzw_table = ctx->scratch_lzw_table;
+    uint16_t *lzw_lengths = ctx->scratch_lzw_lengths;
+    uint8_t *lzw_pixels = ctx->scratch_lzw_pixels;
+
+    int current_pixel_idx = 0;
+    int current_line_idx = 0;
+    int interlaced_pass = 0;
+
+    for (i = 0; i < clear_code; i++) {
+        lzw_pixels[i] = lzw_pixels[GIF_LZW_TABLE_ENTRIES + i] = (uint8_t)i;
+        lzw_table[i] = 0xFFFF; // LINK_END equivalent
+        lzw_lengths[i] = 1 | GIF_LZW_LENGTH_RUN;
+    }
+init_codetable_safe:
+    codesize = code_start_size + 1;
+    sMask = (1 << codesize) - 1;
+    nextcode = eoi_code + 1;
+    nextlim = (1 << codesize);
+
+    GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+    if (code == clear_code) {
+        GIF_STAT_INC(ctx, clear_codes);
+        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+    }
+    if (code == eoi_code) { // Handle immediate EOI after clear code
+        return GIF_SUCCESS;
+    }
+    if (code >= clear_code) {
+        gif_report_error(ctx, GIF_ERROR_DECODE, "Invalid initial LZW code in Safe mode.");
+        return GIF_ERROR_DECODE;
+    }
+    ctx->scratch_line_buffer[current_pixel_idx++] = (uint8_t)code;
+    gif_flush_rows(ctx, frame_buffer, &current_pixel_idx, &current_line_idx, &interlaced_pass);
+
+    oldcode = code;
+    GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+
+    while (code != eoi_code) {
+        if (code == clear_code) {
+            GIF_STAT_INC(ctx, clear_codes);
+            goto init_codetable_safe;
+        }
+        // Check if code is valid before attempting to use it
+        if (code > nextcode) {
+             gif_report_error(ctx, GIF_ERROR_DECODE, "LZW code out of dictionary bounds.");
+             return GIF_ERROR_DECODE;
+        }
+
+        if (nextcode < GIF_LZW_TABLE_ENTRIES) {
+            // New entry: string of oldcode followed by the first byte of code (K, K, K sequence if code == nextcode)
+            lzw_table[nextcode] = oldcode;
+            lzw_pixels[nextcode] = lzw_pixels[GIF_LZW_TABLE_ENTRIES + (code == nextcode ? oldcode : code)];
+            lzw_pixels[GIF_LZW_TABLE_ENTRIES + nextcode] = lzw_pixels[GIF_LZW_TABLE_ENTRIES + oldcode];
+            lzw_lengths[nextcode] = (uint16_t)(lzw_lengths[oldcode] + 1);
+            if (lzw_pixels[nextcode] != lzw_pixels[GIF_LZW_TABLE_ENTRIES + nextcode]) { // Still a run if the appended byte repeats the run
+                lzw_lengths[nextcode] &= GIF_LZW_LENGTH_MASK;
+            }
+            nextcode++;
+            if (nextcode >= nextlim && codesize < GIF_MAX_CODE_SIZE) {
+                codesize++;
+                nextlim <<= 1;
+                sMask = nextlim - 1;
+            }
+        }
+        current_pixel_idx += gif_lzw_write_string(lzw_table, lzw_pixels, lzw_lengths, code, ctx->scratch_line_buffer + current_pixel_idx);
+
+        // Render pixels to frame buffer as lines are completed
+        gif_flush_rows(ctx, frame_buffer, &current_pixel_idx, &current_line_idx, &interlaced_pass);
+        oldcode = code;
+        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+
+        if (nextcode >= GIF_LZW_TABLE_ENTRIES) {
+            // Dictionary is frozen until the next clear code: fixed-size codes that are always valid, no inserts
+            GIF_STAT_INC(ctx, dictionary_full);
+            while (code != eoi_code && code != clear_code) {
+                current_pixel_idx += gif_lzw_write_string(lzw_table, lzw_pixels, lzw_lengths, code, ctx->scratch_line_buffer + current_pixel_idx);
+                gif_flush_rows(ctx, frame_buffer, &current_pixel_idx, &current_line_idx, &interlaced_pass);
+                GET_LZW_CODE(ctx, p, bitnum, GIF_MAX_CODE_SIZE, (GIF_LZW_TABLE_ENTRIES - 1), code, ulBits);
+            }
+        }
+    }
+
+    return GIF_SUCCESS;
+}
+#endif // GIF_MODE_TURBO
+
+#ifndef GIF_NO_LZW_SPECIALIZATION
+/**
+ * @brief Runs an LZW engine instantiated for the frame's initial code size.
+ *
+ * Every case inlines the engine with a constant code size, so the clear code, EOI code
+ * and initial masks are folded into each instance.
+ */
+#define GIF_LZW_DISPATCH(engine, ctx, frame_buffer, ulBits) \
+    do { \
+        switch ((ctx)->lzw_code_start_size) { \
+            case 2: return engine(ctx, frame_buffer, ulBits, 2); \
+            case 3: return engine(ctx, frame_buffer, ulBits, 3); \
+            case 4: return engine(ctx, frame_buffer, ulBits, 4); \
+            case 5: return engine(ctx, frame_buffer, ulBits, 5); \
+            case 6: return engine(ctx, frame_buffer, ulBits, 6); \
+            case 7: return engine(ctx, frame_buffer, ulBits, 7); \
+            default: return engine(ctx, frame_buffer, ulBits, 8); \
+        } \
+    } while(0)
+#else
+/** @brief Runs an LZW engine with the frame's initial code size as a runtime value (smaller code). */
+#define GIF_LZW_DISPATCH(engine, ctx, frame_buffer, ulBits) \
+    return engine(ctx, frame_buffer, ulBits, (ctx)->lzw_code_start_size)
+#endif
+
+#ifdef GIF_MODE_TURBO
+/** @brief Shared state of the segment tasks of a parallel frame decode. */
+typedef struct {
+    /** @brief Context of the frame, read-only while the tasks run. */
+    const GIF_Context *ctx;
+    /** @brief Segment table. */
+    GIF_LZWSegment *segments;
+    /** @brief Number of segments. */
+    int segment_count;
+    /** @brief Number of tasks; task `i` decodes segments `i`, `i + workers`, ... */
+    int workers;
+    /** @brief LZW data of the frame. */
+    uint8_t *stream;
+    /** @brief Size of the LZW data in bytes. */
+    size_t stream_size;
+} GIF_ParallelJob;
+
+/**
+ * @brief Collects the LZW sub-blocks of the current frame into one buffer.
+ *
+ * Reads up to and including the block terminator. A missing terminator at the end of
+ * the file ends the frame, as in gif_get_more_lzw_data().
+ * @param ctx Pointer to the GIF context.
+ * @param dest Destination buffer.
+ * @param capacity Size of the destination buffer.
+ * @param size Number of bytes collected, set on success.
+ * @return 1 on success, 0 if the data does not fit or a sub-block is truncated.
+ */
+static int gif_gather_lzw_stream(GIF_Context *ctx, uint8_t *dest, size_t capacity, size_t *size) {
+    size_t used = 0;
+
+    while (ctx->current_pos < ctx->gif_size) {
+        size_t c = ctx->gif_data[ctx->current_pos++];
+        if (c == 0) { // Block terminator
+            break;
+        }
+        if (c > ctx->gif_size - ctx->current_pos || c > capacity - used) {
+            return 0;
+        }
+        memcpy(dest + used, ctx->gif_data + ctx->current_pos, c);
+        ctx->current_pos += c;
+        used += c;
+    }
+    *size = used;
+    return 1;
+}
+
+/**
+ * @brief Sets up a private context reading LZW data from a collected stream.
+ *
+ * The copy reports no errors and never reads the GIF data, so several of them can
+ * decode segments of the same frame concurrently.
+ * @param seg_ctx Context to set up.
+ * @param ctx Context of the frame.
+ * @param stream LZW data of the frame.
+ * @param stream_size Size of the LZW data in bytes.
+ * @param byte_pos Byte offset to start reading at.
+ * @param ulBits First 32 bits of LZW data from `byte_pos`, set on return.
+ */
+static void gif_lzw_stream_context(GIF_Context *seg_ctx, const GIF_Context *ctx, uint8_t *stream, size_t stream_size,
+                                   uint32_t byte_pos, uint32_t *ulBits) {
+    size_t bytes_avail = stream_size > byte_pos ? stream_size - byte_pos : 0;
+
+    *seg_ctx = *ctx;
+    seg_ctx->error_callback = NULL;
+    seg_ctx->scratch_lzw_buffer = stream;
+    seg_ctx->lzw_data_size = (int)stream_size;
+    seg_ctx->lzw_read_offset = (int)byte_pos;
+    seg_ctx->lzw_end_of_frame = 1; // Everything is in the buffer, never refill from the GIF data
+    *ulBits = 0;
+    memcpy(ulBits, stream + byte_pos, bytes_avail < sizeof(uint32_t) ? bytes_avail : sizeof(uint32_t));
+}
+
+/**
+ * @brief Splits the LZW data of a frame into segments at clear codes (lengths-only pre-pass).
+ *
+ * Only code sizes and string lengths are tracked, which is enough to know where every
+ * clear code sits in the bitstream and how many pixels precede it. Segments shorter than
+ * `target` pixels are merged with the next one.
+ * @param ctx Context reading the collected LZW data (see gif_lzw_stream_context()).
+ * @param ulBits First 32 bits of LZW data.
+ * @param lengths Table of GIF_LZW_TABLE_ENTRIES string lengths.
+ * @param segments Segment table of GIF_PARALLEL_MAX_SEGMENTS entries.
+ * @param target Minimum number of pixels per segment.
+ * @return Number of segments, or -1 if the data is not valid.
+ */
+static int gif_lzw_scan_segments(GIF_Context *ctx, uint32_t ulBits, uint16_t *lengths, GIF_LZWSegment *segments,
+                                 uint32_t target) {
+    int i, bitnum = 0, count = 1;
+    uint16_t code, oldcode, codesize, nextcode, nextlim;
+    const uint16_t clear_code = (uint16_t)(1 << ctx->lzw_code_start_size);
+    const uint16_t eoi_code = clear_code + 1;
+    uint32_t sMask;
+    uint8_t *p = ctx->scratch_lzw_buffer;
+    uint32_t out_size = ctx->frame_width * ctx->frame_height;
+    uint32_t out_pos = 0;
+
+    segments[0].byte_pos = 0;
+    segments[0].bitnum = 0;
+    segments[0].out_start = 0;
+    for (i = 0; i < clear_code; i++) {
+        lengths[i] = 1;
+    }
+init_codetable_scan:
+    codesize = ctx->lzw_code_start_size + 1;
+    sMask = (1 << codesize) - 1;
+    nextcode = eoi_code + 1;
+    nextlim = (1 << codesize);
+
+    GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+    if (code == clear_code) {
+        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+    }
+    if (code == eoi_code) {
+        goto done;
+    }
+    if (code >= clear_code) {
+        return -1;
+    }
+    out_pos++;
+
+    oldcode = code;
+    GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+
+    while (code != eoi_code && out_pos < out_size) {
+        if (code == clear_code) {
+            // The next segment starts right after this clear code
+            if (out_pos - segments[count - 1].out_start >= target && count < GIF_PARALLEL_MAX_SEGMENTS) {
+                segments[count].byte_pos = (uint32_t)ctx->lzw_read_offset + (uint32_t)(bitnum >> 3);
+                segments[count].bitnum = (uint32_t)(bitnum & 7);
+                segments[count].out_start = out_pos;
+                count++;
+            }
+            goto init_codetable_scan;
+        }
+        if (code > nextcode) {
+            return -1;
+        }
+        if (nextcode < GIF_LZW_TABLE_ENTRIES) {
+            lengths[nextcode] = (uint16_t)(lengths[oldcode] + 1);
+            nextcode++;
+            if (nextcode >= nextlim && codesize < GIF_MAX_CODE_SIZE) {
+                codesize++;
+                nextlim <<= 1;
+                sMask = (sMask << 1) | 1;
+            }
+        }
+        out_pos += (lengths[code] < out_size - out_pos) ? lengths[code] : out_size - out_pos;
+
+        oldcode = code;
+        GET_LZW_CODE(ctx, p, bitnum, codesize, sMask, code, ulBits);
+    }
+
+done:
+    for (i = 0; i < count - 1; i++) {
+        segments[i].out_end = segments[i + 1].out_start;
+    }
+    segments[count - 1].out_end = out_pos;
+    return count;
+}
+
+/**
+ * @brief Instantiates gif_lzw_decode_plane() for the frame's initial code size.
+ * @param ctx Context reading the LZW data.
+ * @param plane Output range, updated on return.
+ * @param ulBits First 32 bits of LZW data.
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+static int gif_lzw_decode_segment(GIF_Context *ctx, GIF_LZWPlane *plane, uint32_t ulBits) {
+    GIF_LZW_DISPATCH(gif_lzw_decode_plane, ctx, plane, ulBits);
+}
+
+/**
+ * @brief Decodes every `workers`-th segment of a frame with one dictionary (GIF_TaskFunc).
+ * @param task_data Pointer to the GIF_ParallelJob.
+ * @param index Worker index.
+ */
+static void gif_parallel_decode_task(void *task_data, int index) {
+    const GIF_ParallelJob *job = (const GIF_ParallelJob *)task_data;
+    GIF_Context seg_ctx;
+    int i;
+
+    for (i = index; i < job->segment_count; i += job->workers) {
+        GIF_LZWSegment *segment = &job->segments[i];
+        GIF_LZWPlane plane;
+        uint32_t ulBits;
+
+        gif_lzw_stream_context(&seg_ctx, job->ctx, job->stream, job->stream_size, segment->byte_pos, &ulBits);
+        seg_ctx.scratch_lzw_dict = (GIF_LZWEntry *)((uint8_t *)job->ctx->parallel_dicts +
+                                                    (size_t)index * GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_DICT_SIZE));
+        plane.out = job->ctx->index_canvas;
+        plane.out_pos = segment->out_start;
+        plane.out_size = segment->out_end;
+        // Over-copying must not reach into the next segment, which another worker may be writing
+        plane.out_capacity = (i == job->segment_count - 1) ? job->ctx->index_canvas_size : segment->out_end;
+        plane.bitnum = (int)segment->bitnum;
+        segment->result = gif_lzw_decode_segment(&seg_ctx, &plane, ulBits);
+        if (segment->result == GIF_SUCCESS && plane.out_pos != segment->out_end) {
+            segment->result = GIF_ERROR_DECODE;
+        }
+    }
+}
+
+/**
+ * @brief Decodes the current frame in parallel segments if possible.
+ *
+ * Declines frames that are too small, have no periodic clear codes, do not fit in the
+ * scratch buffers, or fail to decode; the read position is then restored so that the
+ * serial decoder handles the frame and reports any error.
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the buffer where the frame will be rendered.
+ * @return 1 if the frame was decoded and rendered, 0 if it was declined.
+ */
+static int gif_decode_lzw_parallel(GIF_Context *ctx, uint8_t *frame_buffer) {
+    size_t out_size = (size_t)ctx->frame_width * ctx->frame_height;
+    size_t start_pos = ctx->current_pos;
+    size_t stream_size;
+    GIF_Context scan_ctx;
+    GIF_ParallelJob job;
+    uint32_t ulBits, target;
+    int i, tasks;
+
+    if (ctx->parallel_workers <= 0 || !ctx->index_canvas || out_size > ctx->index_canvas_size ||
+        out_size < GIF_PARALLEL_MIN_PIXELS || ctx->lzw_code_start_size < 2 || ctx->lzw_code_start_size > 8) {
+        return 0;
+    }
+    if (!gif_gather_lzw_stream(ctx, ctx->parallel_stream, ctx->parallel_stream_capacity, &stream_size)) {
+        ctx->current_pos = start_pos;
+        return 0;
+    }
+
+    tasks = ctx->parallel_workers * 4; // Several segments per worker to balance uneven segments
+    if (tasks > GIF_PARALLEL_MAX_SEGMENTS) {
+        tasks = GIF_PARALLEL_MAX_SEGMENTS;
+    }
+    target = (uint32_t)(out_size / (size_t)tasks);
+    gif_lzw_stream_context(&scan_ctx, ctx, ctx->parallel_stream, stream_size, 0, &ulBits);
+    // The first worker dictionary is free until the segments are decoded
+    job.segment_count = gif_lzw_scan_segments(&scan_ctx, ulBits, (uint16_t *)ctx->parallel_dicts, ctx->parallel_segments, target);
+    if (job.segment_count < 2) {
+        ctx->current_pos = start_pos;
+        return 0;
+    }
+
+    job.ctx = ctx;
+    job.segments = ctx->parallel_segments;
+    job.workers = ctx->parallel_workers < job.segment_count ? ctx->parallel_workers : job.segment_count;
+    job.stream = ctx->parallel_stream;
+    job.stream_size = stream_size;
+    if (ctx->parallel_for) {
+        ctx->parallel_for(ctx->parallel_user_data, job.workers, gif_parallel_decode_task, &job);
+    } else {
+        for (i = 0; i < job.workers; i++) {
+            gif_parallel_decode_task(&job, i);
+        }
+    }
+    for (i = 0; i < job.segment_count; i++) {
+        if (job.segments[i].result != GIF_SUCCESS) {
+            ctx->current_pos = start_pos;
+            return 0;
+        }
+    }
+
+    gif_render_plane(ctx, frame_buffer, ctx->index_canvas, job.segments[job.segment_count - 1].out_end);
+    ctx->index_canvas_decoded = job.segments[job.segment_count - 1].out_end;
+    ctx->lzw_end_of_frame = 1; // The block terminator has been consumed
+    return 1;
+}
+
+/** @brief Shared state of the tasks of gif_decode_frame_planes(). */
+typedef struct {
+    /** @brief Context of the GIF, read-only while the tasks run. */
+    const GIF_Context *ctx;
+    /** @brief Planes to decode. */
+    GIF_FramePlane *planes;
+    /** @brief Number of planes. */
+    int count;
+    /** @brief Number of tasks; task `i` decodes planes `i`, `i + workers`, ... */
+    int workers;
+    /** @brief Scratch buffer holding GIF_WORKER_SCRATCH_SIZE bytes per task. */
+    uint8_t *worker_scratch;
+} GIF_PlaneJob;
+
+/**
+ * @brief Decodes every `workers`-th plane of a batch with one dictionary (GIF_TaskFunc).
+ * @param task_data Pointer to the GIF_PlaneJob.
+ * @param index Worker index.
+ */
+static void gif_decode_planes_task(void *task_data, int index) {
+    const GIF_PlaneJob *job = (const GIF_PlaneJob *)task_data;
+    uint8_t *scratch = job->worker_scratch + (size_t)index * GIF_WORKER_SCRATCH_SIZE;
+    GIF_Context frame_ctx;
+    int i;
+
+    scratch += (GIF_SCRATCH_ALIGN - ((uintptr_t)scratch & (GIF_SCRATCH_ALIGN - 1))) & (GIF_SCRATCH_ALIGN - 1);
+    for (i = index; i < job->count; i += job->workers) {
+        GIF_FramePlane *plane = &job->planes[i];
+        const GIF_FrameInfo *frame = plane->frame;
+        GIF_LZWPlane out;
+        uint32_t ulBits;
+
+        // Private context reading the frame's sub-blocks straight from the (shared, read-only) GIF data
+        frame_ctx = *job->ctx;
+        frame_ctx.error_callback = NULL;
+        frame_ctx.scratch_lzw_dict = (GIF_LZWEntry *)scratch;
+        frame_ctx.scratch_lzw_buffer = scratch + GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_DICT_SIZE);
+        frame_ctx.current_pos = frame->lzw_pos;
+        frame_ctx.frame_width = frame->width;
+        frame_ctx.frame_height = frame->height;
+        frame_ctx.lzw_code_start_size = frame->lzw_code_start_size;
+
+        plane->decoded = 0;
+        if ((size_t)frame->width * frame->height > plane->indices_size) {
+            plane->result = GIF_ERROR_BUFFER_TOO_SMALL;
+            continue;
+        }
+        plane->result = gif_lzw_begin_frame(&frame_ctx, &ulBits);
+        if (plane->result != GIF_SUCCESS) {
+            continue;
+        }
+        out.out = plane->indices;
+        out.out_pos = 0;
+        out.out_size = (uint32_t)frame->width * frame->height;
+        out.out_capacity = plane->indices_size;
+        out.bitnum = 0;
+        plane->result = gif_lzw_decode_segment(&frame_ctx, &out, ulBits);
+        plane->decoded = out.out_pos;
+    }
+}
+#endif
+
+/**
+ * @brief Decodes LZW data for a single frame.
+ * @param ctx Pointer to the GIF context.
+ * @param frame_buffer Pointer to the buffer where the frame will be rendered.
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+static int gif_decode_lzw(GIF_Context *restrict ctx, uint8_t *restrict frame_buffer) {
+    uint32_t ulBits;
+    int result;
+
+#ifdef GIF_MODE_TURBO
+    ctx->index_canvas_decoded = 0;
+    if (gif_decode_lzw_parallel(ctx, frame_buffer)) {
+        return GIF_SUCCESS;
+    }
+#endif
+    result = gif_lzw_begin_frame(ctx, &ulBits);
+    if (result != GIF_SUCCESS) {
+        return result;
+    }
+#ifdef GIF_MODE_TURBO
+    if (ctx->index_canvas && (size_t)ctx->frame_width * ctx->frame_height <= ctx->index_canvas_size) {
+        GIF_LZW_DISPATCH(gif_decode_lzw_canvas, ctx, frame_buffer, ulBits);
+    }
+    if (!ctx->has_transparency && !(ctx->ucGIFBits & 0x40)) { // Opaque and not interlaced
+        GIF_LZW_DISPATCH(gif_decode_lzw_fused, ctx, frame_buffer, ulBits);
+    }
+    GIF_LZW_DISPATCH(gif_decode_lzw_turbo, ctx, frame_buffer, ulBits);
+#else
+    GIF_LZW_DISPATCH(gif_decode_lzw_safe, ctx, frame_buffer, ulBits);
+#endif
+}
+
+/**
+ * @brief Reads an image descriptor, its local color table and the initial LZW code size.
+ *
+ * Expects the read position right after the image separator and leaves it at the first
+ * LZW sub-block.
+ * @param ctx Pointer to the GIF context.
+ * @return GIF_SUCCESS on success, or an error code.
+ */
+static int gif_read_image_descriptor(GIF_Context *ctx) {
+    ctx->frame_x_off = gif_read_u16_le(ctx->gif_data + ctx->current_pos); gif_skip_bytes_internal(ctx, 2);
+    ctx->frame_y_off = gif_read_u16_le(ctx->gif_data + ctx->current_pos); gif_skip_bytes_internal(ctx, 2);
+    ctx->frame_width = gif_read_u16_le(ctx->gif_data + ctx->current_pos); gif_skip_bytes_internal(ctx, 2);
+    ctx->frame_height = gif_read_u16_le(ctx->gif_data + ctx->current_pos); gif_skip_bytes_internal(ctx, 2);
+
+    // Validate frame dimensions
+    if (ctx->frame_width == 0 || ctx->frame_height == 0) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_FRAME_DIMENSIONS, "Frame has zero width or height.");
+        return GIF_ERROR_INVALID_FRAME_DIMENSIONS;
+    }
+    if (ctx->frame_width > GIF_MAX_WIDTH) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_FRAME_DIMENSIONS, "Frame width exceeds GIF_MAX_WIDTH.");
+        return GIF_ERROR_INVALID_FRAME_DIMENSIONS;
+    }
+    if (ctx->frame_x_off + ctx->frame_width > ctx->canvas_width ||
+        ctx->frame_y_off + ctx->frame_height > ctx->canvas_height)
+    {
+        gif_report_error(ctx, GIF_ERROR_INVALID_FRAME_DIMENSIONS, "Frame extends beyond canvas boundaries.");
+        return GIF_ERROR_INVALID_FRAME_DIMENSIONS;
+    }
+
+    uint8_t fisrz = gif_read_byte_internal(ctx);
+    ctx->ucGIFBits = fisrz;
+
+    if (fisrz & 0x80) { // Local Color Table Flag
+        int lct_size = 1 << ((fisrz & 0x07) + 1);
+        if (lct_size > GIF_MAX_COLORS) {
+            gif_report_error(ctx, GIF_ERROR_UNSUPPORTED_COLOR_DEPTH, "Local Color Table size exceeds GIF_MAX_COLORS.");
+            return GIF_ERROR_UNSUPPORTED_COLOR_DEPTH;
+        }
+        if (gif_read_bytes_internal(ctx, ctx->local_palette_colors, (size_t)lct_size * 3) < (size_t)lct_size * 3) {
+            gif_report_error(ctx, GIF_ERROR_EARLY_EOF, "Early EOF while reading Local Color Table.");
+            return GIF_ERROR_EARLY_EOF;
+        }
+        ctx->active_palette_colors = ctx->local_palette_colors;
+    } else {
+        ctx->active_palette_colors = ctx->global_palette_colors;
+    }
+
+    ctx->lzw_code_start_size = gif_read_byte_internal(ctx);
+    return GIF_SUCCESS;
+}
+
+/**
+ * @brief Moves the read position back to the first frame for the next loop.
+ *
+ * The frame buffer still holds the last frame, so unlike gif_rewind() the previous
+ * frame stays known.
+ * @param ctx Pointer to the GIF context.
+ */
+static void gif_rewind_stream(GIF_Context *ctx) {
+    ctx->current_pos = ctx->anim_start_pos;
+    ctx->lzw_end_of_frame = 0;
+    ctx->lzw_read_offset = 0;
+    ctx->lzw_data_size = 0;
+}
+
+/**
+ * @brief Advances to the next image of the animation and reads its descriptor.
+ *
+ * Handles extensions on the way and restarts the animation at the trailer according
+ * to the loop count.
+ * @param ctx Pointer to the GIF context.
+ * @return 1 if an image descriptor was read, 0 when the animation is finished, -1 on error.
+ */
+static int gif_next_image(GIF_Context *ctx) {
+    if (ctx->current_pos >= ctx->gif_size) {
+        if (ctx->loop_count == -1 || ctx->loop_count > 0) {
+            if (ctx->loop_count > 0) ctx->loop_count--;
+            gif_rewind_stream(ctx);
+        } else {
+            return 0; // Animation finished
+        }
+    }
+
+    uint8_t separator;
+    while (ctx->current_pos < ctx->gif_size) {
+        separator = gif_read_byte_internal(ctx);
+        if (separator == 0x3B) { // GIF Trailer
+            if (ctx->loop_count == -1 || ctx->loop_count > 0) {
+                if (ctx->loop_count > 0) ctx->loop_count--;
+                gif_rewind_stream(ctx);
+                continue; // Try again from start of animation
+            }
+            return 0; // Animation finished
+        } else if (separator == 0x21) { // Extension Introducer
+            gif_read_ext(ctx);
+        } else if (separator == 0x2C) { // Image Descriptor
+            break; // Found an image, proceed to decode
+        } else {
+            gif_report_error(ctx, GIF_ERROR_BAD_FILE, "Unexpected byte in GIF stream.");
+            return -1;
+        }
+    }
+
+    if (ctx->current_pos >= ctx->gif_size) {
+        return 0; // No more frames
+    }
+
+    if (gif_read_image_descriptor(ctx) != GIF_SUCCESS) {
+        return -1;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Records the parameters of the current frame, right after its image descriptor.
+ * @param ctx Pointer to the GIF context.
+ * @param frame Frame index entry to fill.
+ */
+static void gif_capture_frame_info(const GIF_Context *ctx, GIF_FrameInfo *frame) {
+    frame->lzw_pos = ctx->current_pos;
+    frame->local_palette_size = (ctx->ucGIFBits & 0x80) ? (uint16_t)(1 << ((ctx->ucGIFBits & 0x07) + 1)) : 0;
+    // The local color table is followed by the initial LZW code size byte
+    frame->local_palette_pos = frame->local_palette_size ? ctx->current_pos - 1 - (size_t)frame->local_palette_size * 3 : 0;
+    frame->x_off = ctx->frame_x_off;
+    frame->y_off = ctx->frame_y_off;
+    frame->width = (uint16_t)ctx->frame_width;
+    frame->height = (uint16_t)ctx->frame_height;
+    frame->delay_ms = ctx->frame_delay_ms;
+    frame->ucGIFBits = ctx->ucGIFBits;
+    frame->lzw_code_start_size = ctx->lzw_code_start_size;
+    frame->has_transparency = ctx->has_transparency;
+    frame->transparent_index = ctx->transparent_index;
+    frame->disposal_method = ctx->disposal_method;
+    frame->hash = 0;
+}
+
+/**
+ * @brief Returns the position after the block terminator of the sub-blocks at `pos`.
+ * @param ctx Pointer to the GIF context.
+ * @param pos Position of the first sub-block.
+ * @return Position after the block terminator, or 0 if the data ends first.
+ */
+static size_t gif_sub_blocks_end(const GIF_Context *ctx, size_t pos) {
+    while (pos < ctx->gif_size) {
+        uint8_t size = ctx->gif_data[pos];
+        pos += (size_t)size + 1;
+        if (size == 0) {
+            return pos;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the position of the image descriptor fields of a frame, after the separator.
+ * @param frame Parameters of the frame.
+ * @return Position of the frame's left position field.
+ */
+static size_t gif_frame_data_pos(const GIF_FrameInfo *frame) {
+    // 9 bytes of descriptor fields, the local color table and the initial LZW code size byte
+    return frame->lzw_pos - 10 - (size_t)frame->local_palette_size * 3;
+}
+
+/**
+ * @brief Hashes the encoded data of a frame with FNV-1a.
+ *
+ * Covers everything that determines the rendered output: descriptor, local palette,
+ * LZW sub-blocks, transparency and disposal. Frames with equal hashes almost certainly
+ * render identically.
+ * @param ctx Pointer to the GIF context.
+ * @param frame Parameters of the frame.
+ * @param end_pos Position after the frame's block terminator.
+ * @return Hash of the frame.
+ */
+static uint32_t gif_hash_frame(const GIF_Context *ctx, const GIF_FrameInfo *frame, size_t end_pos) {
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for (i = gif_frame_data_pos(frame); i < end_pos; i++) {
+        hash = (hash ^ ctx->gif_data[i]) * 16777619u;
+    }
+    hash = (hash ^ frame->has_transparency) * 16777619u;
+    hash = (hash ^ frame->transparent_index) * 16777619u;
+    hash = (hash ^ frame->disposal_method) * 16777619u;
+    return hash;
+}
+
+/**
+ * @brief Compares the current frame with the last frame rendered by gif_next_frame().
+ * @param ctx Pointer to the GIF context.
+ * @param frame Parameters of the current frame.
+ * @param end_pos Position after the current frame's block terminator, or 0 if unknown.
+ * @return 2 if rendering the frame would not change the frame buffer, 1 if only its LZW
+ * data (and so its index plane) is the same, 0 otherwise.
+ */
+static int gif_frame_repeats(const GIF_Context *ctx, const GIF_FrameInfo *frame, size_t end_pos) {
+    const GIF_FrameInfo *last = &ctx->last_frame;
+    size_t lzw_size = end_pos - frame->lzw_pos;
+
+    if (!end_pos || !ctx->last_frame_end || lzw_size != ctx->last_frame_end - last->lzw_pos ||
+        frame->width != last->width || frame->height != last->height ||
+        (frame->ucGIFBits & 0x40) != (last->ucGIFBits & 0x40) || frame->lzw_code_start_size != last->lzw_code_start_size) {
+        return 0;
+    }
+    if (frame->lzw_pos != last->lzw_pos && memcmp(ctx->gif_data + frame->lzw_pos, ctx->gif_data + last->lzw_pos, lzw_size) != 0) {
+        return 0;
+    }
+    if (frame->x_off != last->x_off || frame->y_off != last->y_off || frame->has_transparency != last->has_transparency ||
+        frame->transparent_index != last->transparent_index || frame->disposal_method != last->disposal_method ||
+        frame->local_palette_size != last->local_palette_size) {
+        return 1;
+    }
+    // Rendering is idempotent: the same indices through the same palette write the same pixels
+    if (frame->local_palette_size && frame->local_palette_pos != last->local_palette_pos &&
+        memcmp(ctx->gif_data + frame->local_palette_pos, ctx->gif_data + last->local_palette_pos,
+               (size_t)frame->local_palette_size * 3) != 0) {
+        return 1;
+    }
+    return 2;
+}
+
+#ifdef GIF_MODE_TURBO
+/** @brief Frame table entry of the frame cache, stored at the end of the cache memory. */
+typedef struct {
+    /** @brief Position of the frame's LZW sub-blocks in `gif_data`, the lookup key. */
+    size_t lzw_pos;
+    /** @brief Position right after the frame's block terminator. */
+    size_t end_pos;
+    /** @brief Offset of the compressed indices in the cache memory. */
+    size_t data_offset;
+    /** @brief Number of decoded indices. */
+    uint32_t decoded;
+    /** @brief Size of the compressed indices; 0 if the frame is not cached. */
+    uint32_t data_size;
+} GIF_FrameCacheEntry;
+
+/**
+ * @brief Compresses palette indices with PackBits.
+ * @param src Indices to compress.
+ * @param len Number of indices.
+ * @param dest Destination buffer.
+ * @param capacity Size of the destination buffer.
+ * @return Compressed size, or 0 if it does not fit in `capacity` bytes.
+ */
+static size_t gif_rle_encode(const uint8_t *src, uint32_t len, uint8_t *dest, size_t capacity) {
+    size_t out = 0;
+    uint32_t i = 0;
+
+    while (i < len) {
+        uint32_t run = 1;
+        while (i + run < len && run < 128 && src[i + run] == src[i]) {
+            run++;
+        }
+        if (run >= 2) { // Control byte 129..255 repeats the next byte 257 - control times
+            if (out + 2 > capacity) {
+                return 0;
+            }
+            dest[out++] = (uint8_t)(257 - run);
+            dest[out++] = src[i];
+            i += run;
+            continue;
+        }
+        uint32_t literal = 1; // Control byte 0..127 copies the next control + 1 bytes
+        while (i + literal < len && literal < 128 && !(i + literal + 1 < len && src[i + literal] == src[i + literal + 1])) {
+            literal++;
+        }
+        if (out + 1 + literal > capacity) {
+            return 0;
+        }
+        dest[out++] = (uint8_t)(literal - 1);
+        memcpy(dest + out, src + i, literal);
+        out += literal;
+        i += literal;
+    }
+    return out;
+}
+
+/**
+ * @brief Expands indices compressed by gif_rle_encode().
+ * @param src Compressed indices.
+ * @param size Compressed size.
+ * @param dest Destination buffer of at least `len` bytes.
+ * @param len Number of indices to expand.
+ */
+static void gif_rle_decode(const uint8_t *src, size_t size, uint8_t *dest, uint32_t len) {
+    size_t in = 0;
+    uint32_t out = 0;
+
+    while (in < size && out < len) {
+        uint32_t control = src[in++];
+        if (control < 128) {
+            uint32_t literal = control + 1;
+            if (literal > len - out || literal > size - in) {
+                return;
+            }
+            memcpy(dest + out, src + in, literal);
+            in += literal;
+            out += literal;
+        } else if (in < size) {
+            uint32_t run = 257 - control;
+            if (run > len - out) {
+                return;
+            }
+            memset(dest + out, src[in++], run);
+            out += run;
+        }
+    }
+}
+
+/**
+ * @brief Returns the frame table entry of frame `index`; the table grows down from the end.
+ * @param ctx Pointer to the GIF context.
+ * @param index Ordinal of the frame in the first pass.
+ * @return Pointer to the entry.
+ */
+static GIF_FrameCacheEntry *gif_frame_cache_entry(GIF_Context *ctx, uint32_t index) {
+    return (GIF_FrameCacheEntry*)(ctx->frame_cache + ctx->frame_cache_size) - 1 - index;
+}
+
+/**
+ * @brief Replays the frame at `current_pos` from the frame cache, skipping LZW decoding.
+ * @param ctx Pointer to the GIF context, positioned at the frame's LZW sub-blocks.
+ * @param frame_buffer Pointer to the RGB888 frame buffer.
+ * @return 1 if the frame was rendered from the cache, 0 if it must be decoded.
+ */
+static int gif_frame_cache_replay(GIF_Context *ctx, uint8_t *frame_buffer) {
+    uint32_t low = 0, high = ctx->frame_cache_frames;
+
+    while (low < high) { // Frames are recorded in stream order
+        uint32_t mid = low + (high - low) / 2;
+        if (gif_frame_cache_entry(ctx, mid)->lzw_pos < ctx->current_pos) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == ctx->frame_cache_frames) {
+        return 0;
+    }
+    const GIF_FrameCacheEntry *entry = gif_frame_cache_entry(ctx, low);
+    if (entry->lzw_pos != ctx->current_pos || entry->data_size == 0 || !ctx->index_canvas ||
+        entry->decoded > ctx->index_canvas_size) {
+        return 0;
+    }
+
+    gif_rle_decode(ctx->frame_cache + entry->data_offset, entry->data_size, ctx->index_canvas, entry->decoded);
+    gif_render_plane(ctx, frame_buffer, ctx->index_canvas, entry->decoded);
+    ctx->index_canvas_decoded = entry->decoded;
+    ctx->current_pos = entry->end_pos;
+    ctx->lzw_end_of_frame = 1;
+    return 1;
+}
+
+/**
+ * @brief Records a frame decoded during the first pass in the frame cache.
+ *
+ * Only frames decoded through the index canvas are compressed; the others, and frames
+ * whose indices no longer fit, get an entry that sends them to the LZW decoder.
+ * @param ctx Pointer to the GIF context, positioned after the frame.
+ * @param lzw_pos Position of the frame's LZW sub-blocks.
+ */
+static void gif_frame_cache_record(GIF_Context *ctx, size_t lzw_pos) {
+    uint32_t count = ctx->frame_cache_frames;
+
+    if (count > 0 && lzw_pos <= gif_frame_cache_entry(ctx, count - 1)->lzw_pos) {
+        return; // Already recorded during the first pass
+    }
+    size_t table_size = (size_t)(count + 1) * sizeof(GIF_FrameCacheEntry);
+    if (table_size > ctx->frame_cache_size || ctx->frame_cache_size - table_size < ctx->frame_cache_used) {
+        return; // The frame table is full
+    }
+
+    GIF_FrameCacheEntry *entry = gif_frame_cache_entry(ctx, count);
+    entry->lzw_pos = lzw_pos;
+    entry->end_pos = ctx->current_pos;
+    entry->data_offset = ctx->frame_cache_used;
+    entry->decoded = ctx->index_canvas_decoded;
+    entry->data_size = 0;
+    if (ctx->index_canvas_decoded) {
+        entry->data_size = (uint32_t)gif_rle_encode(ctx->index_canvas, ctx->index_canvas_decoded,
+                                                    ctx->frame_cache + ctx->frame_cache_used,
+                                                    ctx->frame_cache_size - table_size - ctx->frame_cache_used);
+        ctx->frame_cache_used += entry->data_size;
+    }
+    ctx->frame_cache_frames = count + 1;
+}
+#endif
+
+/**
+ * @brief Starts a walk over the frames on a copy of the context.
+ *
+ * The copy starts at the first frame with the Graphic Control Extension parameters reset,
+ * so the decoding state of the context is left untouched.
+ * @param ctx Pointer to the GIF context.
+ * @param scan Receives the copy to walk.
+ */
+static void gif_scan_begin(const GIF_Context *ctx, GIF_Context *scan) {
+    *scan = *ctx;
+    scan->current_pos = scan->anim_start_pos;
+    scan->frame_delay_ms = 0;
+    scan->has_transparency = 0;
+    scan->transparent_index = 0;
+    scan->disposal_method = 0;
+    scan->last_frame_end = 0;
+}
 
-            for (i = 0; i < ctx->frame_width; i++) {
-                uint8_t pixel_index = src_pixels[i];
-                if (ctx->has_transparency && pixel_index == ctx->transparent_index) {
-                    if (ctx->disposal_method == 2) {
-                        memcpy(dest_row_start + i*3, palette + ctx->background_index*3, 3);
-                    }
-                } else {
-                    memcpy(dest_row_start + i*3, palette + pixel_index*3, 3);
-                }
+/**
+ * @brief Advances a walk started by gif_scan_begin() to the next frame, without decoding it.
+ * @param scan Context copy being walked.
+ * @param frame Receives the parameters of the frame.
+ * @param end_pos Receives the position after the frame's block terminator.
+ * @return GIF_SUCCESS if a frame was found, GIF_ERROR_NO_FRAME at the end of the
+ * animation, or an error code.
+ */
+static int gif_scan_frame(GIF_Context *scan, GIF_FrameInfo *frame, size_t *end_pos) {
+    while (scan->current_pos < scan->gif_size) {
+        uint8_t separator = gif_read_byte_internal(scan);
+        if (separator == 0x3B) { // GIF Trailer
+            break;
+        } else if (separator == 0x21) { // Extension Introducer
+            gif_read_ext(scan);
+        } else if (separator == 0x2C) { // Image Descriptor
+            int result = gif_read_image_descriptor(scan);
+            if (result != GIF_SUCCESS) {
+                return result;
             }
-            // Shift remaining pixels to the beginning of the scratch_line_buffer
-            memmove(ctx->scratch_line_buffer, ctx->scratch_line_buffer + ctx->frame_width, (size_t)(current_pixel_idx - ctx->frame_width));
-            current_pixel_idx -= ctx->frame_width;
-            current_line_idx++;
+            gif_capture_frame_info(scan, frame);
+            gif_discard_sub_blocks(scan);
+            *end_pos = scan->current_pos;
+            return GIF_SUCCESS;
+        } else {
+            gif_report_error(scan, GIF_ERROR_BAD_FILE, "Unexpected byte in GIF stream.");
+            return GIF_ERROR_BAD_FILE;
         }
-        oldcode = code;
     }
-#endif // GIF_MODE_TURBO
+    return GIF_ERROR_NO_FRAME;
+}
 
-    return GIF_SUCCESS;
+/**
+ * @brief Extends a rectangle, kept as {left, top, right, bottom}, to cover a frame.
+ * @param rect Rectangle edges; left and top start at 0xFFFFFFFF for an empty rectangle.
+ * @param frame Parameters of the frame.
+ */
+static void gif_union_rect(uint32_t rect[4], const GIF_FrameInfo *frame) {
+    if (frame->x_off < rect[0]) rect[0] = frame->x_off;
+    if (frame->y_off < rect[1]) rect[1] = frame->y_off;
+    if ((uint32_t)frame->x_off + frame->width > rect[2]) rect[2] = (uint32_t)frame->x_off + frame->width;
+    if ((uint32_t)frame->y_off + frame->height > rect[3]) rect[3] = (uint32_t)frame->y_off + frame->height;
+}
+
+/**
+ * @brief Stores rectangle edges accumulated by gif_union_rect() as a GIF_Rect.
+ * @param dest Destination rectangle; empty if no frame was added.
+ * @param rect Rectangle edges {left, top, right, bottom}.
+ */
+static void gif_store_rect(GIF_Rect *dest, const uint32_t rect[4]) {
+    if (rect[2] == 0) {
+        memset(dest, 0, sizeof(GIF_Rect));
+        return;
+    }
+    dest->x = (uint16_t)rect[0];
+    dest->y = (uint16_t)rect[1];
+    dest->width = (uint16_t)(rect[2] - rect[0]);
+    dest->height = (uint16_t)(rect[3] - rect[1]);
 }
 
 // --- API Function Implementations ---
@@ -854,14 +3012,13 @@ int gif_init(GIF_Context *ctx, const uint8_t *data, size_t size, uint8_t *scratc
         return GIF_ERROR_INVALID_PARAM;
     }
 
+    memset(ctx, 0, sizeof(GIF_Context));
+
     if (scratch_buffer_size < GIF_SCRATCH_BUFFER_REQUIRED_SIZE) {
-        gif_report_error(ctx, GIF_ERROR_BUFFER_TOO_SMALL,
-            "Scratch buffer too small. Required: %zu bytes.",
-            GIF_SCRATCH_BUFFER_REQUIRED_SIZE);
+        gif_report_error(ctx, GIF_ERROR_BUFFER_TOO_SMALL, "Scratch buffer smaller than GIF_SCRATCH_BUFFER_REQUIRED_SIZE.");
         return GIF_ERROR_BUFFER_TOO_SMALL;
     }
 
-    memset(ctx, 0, sizeof(GIF_Context));
     ctx->gif_data = data;
     ctx->gif_size = size;
     ctx->current_pos = 0;
@@ -869,19 +3026,22 @@ int gif_init(GIF_Context *ctx, const uint8_t *data, size_t size, uint8_t *scratc
 
     uint8_t *current_scratch_ptr = scratch_buffer;
 #ifdef GIF_MODE_TURBO
+    // Carve every region at a cache-line boundary so a dictionary entry never straddles two lines
+    current_scratch_ptr += (GIF_SCRATCH_ALIGN - ((uintptr_t)current_scratch_ptr & (GIF_SCRATCH_ALIGN - 1))) & (GIF_SCRATCH_ALIGN - 1);
+    ctx->scratch_lzw_dict = (GIF_LZWEntry*)current_scratch_ptr;
+    current_scratch_ptr += GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_DICT_SIZE);
+    ctx->scratch_lzw_strings = current_scratch_ptr;
+    current_scratch_ptr += GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_STRINGS_SIZE + GIF_SCRATCH_LZW_COPY_PAD);
     ctx->scratch_lzw_buffer = current_scratch_ptr;
-    current_scratch_ptr += GIF_SCRATCH_LZW_MAIN_BUF_SIZE;
-    ctx->scratch_lzw_dict_symbols = current_scratch_ptr;
-    current_scratch_ptr += GIF_SCRATCH_LZW_DICT_SYMBOLS_SIZE;
-    ctx->scratch_lzw_dict_lengths = current_scratch_ptr;
-    current_scratch_ptr += GIF_SCRATCH_LZW_DICT_LENGTHS_SIZE;
-    ctx->scratch_lzw_pixels_suffix = current_scratch_ptr;
-    current_scratch_ptr += GIF_SCRATCH_LZW_PIXELS_SUFFIX_SIZE;
+    current_scratch_ptr += GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_MAIN_BUF_SIZE);
 #else
-    ctx->scratch_lzw_buffer = current_scratch_ptr;
-    current_scratch_ptr += GIF_SCRATCH_LZW_MAIN_BUF_SIZE;
+    current_scratch_ptr += (uintptr_t)current_scratch_ptr & 1; // Align the 16-bit tables
     ctx->scratch_lzw_table = (uint16_t*)current_scratch_ptr;
     current_scratch_ptr += GIF_SCRATCH_LZW_TABLE_SIZE;
+    ctx->scratch_lzw_lengths = (uint16_t*)current_scratch_ptr;
+    current_scratch_ptr += GIF_SCRATCH_LZW_LENGTHS_SIZE;
+    ctx->scratch_lzw_buffer = current_scratch_ptr;
+    current_scratch_ptr += GIF_SCRATCH_LZW_MAIN_BUF_SIZE;
     ctx->scratch_lzw_pixels = current_scratch_ptr;
     current_scratch_ptr += GIF_SCRATCH_LZW_PIXELS_SIZE;
 #endif
@@ -935,106 +3095,589 @@ int gif_next_frame(GIF_Context *ctx, uint8_t *frame_buffer, int *delay_ms) {
         return GIF_ERROR_INVALID_PARAM;
     }
 
-    if (ctx->current_pos >= ctx->gif_size) {
-        if (ctx->loop_count == -1 || ctx->loop_count > 0) {
-            if (ctx->loop_count > 0) ctx->loop_count--;
-            gif_rewind(ctx);
-        } else {
-            return 0; // Animation finished
+    int image = gif_next_image(ctx);
+    if (image != 1) {
+        return image;
+    }
+
+    GIF_FrameInfo frame;
+    gif_capture_frame_info(ctx, &frame);
+    size_t end_pos = gif_sub_blocks_end(ctx, frame.lzw_pos);
+    int repeats = gif_frame_repeats(ctx, &frame, end_pos);
+    if (repeats == 2) {
+        ctx->current_pos = end_pos;
+        ctx->lzw_end_of_frame = 1;
+        GIF_STAT_INC(ctx, frames_reused);
+    }
+#ifdef GIF_MODE_TURBO
+    else if (repeats == 1 && ctx->index_canvas_decoded) { // The index canvas still holds the plane
+        gif_render_plane(ctx, frame_buffer, ctx->index_canvas, ctx->index_canvas_decoded);
+        ctx->current_pos = end_pos;
+        ctx->lzw_end_of_frame = 1;
+        GIF_STAT_INC(ctx, frames_reused);
+    } else if (ctx->frame_cache && gif_frame_cache_replay(ctx, frame_buffer)) {
+        GIF_STAT_INC(ctx, frames_reused); // Rendered from the frame cache
+    }
+#endif
+    else {
+        int decode_result = gif_decode_lzw(ctx, frame_buffer);
+        if (!ctx->lzw_end_of_frame) {
+            gif_discard_sub_blocks(ctx); // Skip sub-blocks left after the End Of Information code
         }
+        if (decode_result != GIF_SUCCESS) {
+            ctx->last_frame_end = 0;
+            gif_report_error(ctx, decode_result, "LZW decoding failed for frame.");
+            return -1;
+        }
+        GIF_STAT_INC(ctx, frames_decoded);
+#ifdef GIF_MODE_TURBO
+        if (ctx->frame_cache) {
+            gif_frame_cache_record(ctx, frame.lzw_pos);
+        }
+#endif
     }
+    ctx->last_frame = frame;
+    ctx->last_frame_end = end_pos;
 
-    uint8_t separator;
-    while (ctx->current_pos < ctx->gif_size) {
-        separator = gif_read_byte_internal(ctx);
-        if (separator == 0x3B) { // GIF Trailer
-            if (ctx->loop_count == -1 || ctx->loop_count > 0) {
-                if (ctx->loop_count > 0) ctx->loop_count--;
-                gif_rewind(ctx);
-                continue; // Try again from start of animation
+    *delay_ms = ctx->frame_delay_ms;
+    return 1;
+}
+
+void gif_rewind(GIF_Context *ctx) {
+    if (ctx) {
+        gif_rewind_stream(ctx);
+        ctx->last_frame_end = 0; // The caller may start over with a fresh frame buffer
+    }
+}
+
+void gif_close(GIF_Context *ctx) {
+    if (ctx) {
+        memset(ctx, 0, sizeof(GIF_Context));
+    }
+}
+
+void gif_set_error_callback(GIF_Context *ctx, GIF_ErrorCallback callback) {
+    if (ctx) {
+        ctx->error_callback = callback;
+    }
+}
+
+int gif_build_frame_index(GIF_Context *ctx, GIF_FrameInfo *frames, int max_frames, int *frame_count) {
+    GIF_Context scan;
+    GIF_FrameInfo frame;
+    size_t end_pos;
+    int count = 0, result;
+
+    if (!ctx || !frame_count || max_frames < 0 || (max_frames > 0 && !frames)) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid parameters for gif_build_frame_index.");
+        return GIF_ERROR_INVALID_PARAM;
+    }
+
+    gif_scan_begin(ctx, &scan);
+    while ((result = gif_scan_frame(&scan, &frame, &end_pos)) == GIF_SUCCESS) {
+        if (count < max_frames) {
+            frame.hash = gif_hash_frame(&scan, &frame, end_pos);
+            frames[count] = frame;
+        }
+        count++;
+    }
+    if (result != GIF_ERROR_NO_FRAME) {
+        return result;
+    }
+
+    *frame_count = count;
+    return GIF_SUCCESS;
+}
+
+int gif_analyze(GIF_Context *ctx, GIF_Analysis *analysis, uint8_t *static_mask, size_t static_mask_size) {
+    GIF_Context scan;
+    GIF_FrameInfo frame;
+    size_t end_pos;
+    uint32_t bounds[4] = {0xFFFFFFFFu, 0xFFFFFFFFu, 0, 0}, changed[4] = {0xFFFFFFFFu, 0xFFFFFFFFu, 0, 0};
+    uint32_t tiles_x, tx, ty;
+    uint64_t duration = 0;
+    int result;
+
+    if (!ctx || !analysis) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid parameters for gif_analyze.");
+        return GIF_ERROR_INVALID_PARAM;
+    }
+    if (static_mask && static_mask_size < GIF_ANALYSIS_MASK_SIZE(ctx->canvas_width, ctx->canvas_height)) {
+        gif_report_error(ctx, GIF_ERROR_BUFFER_TOO_SMALL, "Static mask smaller than GIF_ANALYSIS_MASK_SIZE.");
+        return GIF_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    memset(analysis, 0, sizeof(GIF_Analysis));
+    tiles_x = (ctx->canvas_width + GIF_ANALYSIS_TILE - 1) / GIF_ANALYSIS_TILE;
+    if (static_mask) {
+        memset(static_mask, 1, GIF_ANALYSIS_MASK_SIZE(ctx->canvas_width, ctx->canvas_height));
+    }
+    gif_scan_begin(ctx, &scan);
+    while ((result = gif_scan_frame(&scan, &frame, &end_pos)) == GIF_SUCCESS) {
+        uint32_t x1 = (uint32_t)frame.x_off + frame.width, y1 = (uint32_t)frame.y_off + frame.height;
+
+        duration += frame.delay_ms < GIF_MIN_DELAY_MS ? GIF_CLAMPED_DELAY_MS : frame.delay_ms;
+        gif_union_rect(bounds, &frame);
+        if (analysis->frame_count > 0 && gif_frame_repeats(&scan, &frame, end_pos) != 2) {
+            gif_union_rect(changed, &frame);
+            if (static_mask) {
+                for (ty = frame.y_off / GIF_ANALYSIS_TILE; ty * GIF_ANALYSIS_TILE < y1; ty++) {
+                    for (tx = frame.x_off / GIF_ANALYSIS_TILE; tx * GIF_ANALYSIS_TILE < x1; tx++) {
+                        static_mask[(size_t)ty * tiles_x + tx] = 0;
+                    }
+                }
             }
-            return 0; // Animation finished
-        } else if (separator == 0x21) { // Extension Introducer
-            gif_read_ext(ctx);
-        } else if (separator == 0x2C) { // Image Descriptor
-            break; // Found an image, proceed to decode
-        } else {
-            gif_report_error(ctx, GIF_ERROR_BAD_FILE, "Unexpected byte in GIF stream.");
-            return -1;
         }
+        scan.last_frame = frame;
+        scan.last_frame_end = end_pos;
+        analysis->frame_count++;
+    }
+    if (result != GIF_ERROR_NO_FRAME) {
+        return result;
     }
 
-    if (ctx->current_pos >= ctx->gif_size) {
-        return 0; // No more frames
+    gif_store_rect(&analysis->bounds, bounds);
+    gif_store_rect(&analysis->changed, changed);
+    analysis->duration_ms = duration > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)duration;
+    analysis->fps_x100 = duration ? (uint32_t)((uint64_t)analysis->frame_count * 100000u / duration) : 0;
+    analysis->is_static = analysis->changed.width == 0;
+    return GIF_SUCCESS;
+}
+
+#ifdef GIF_ENABLE_STATS
+void gif_reset_stats(GIF_Context *ctx) {
+    if (ctx) {
+        memset(&ctx->stats, 0, sizeof(ctx->stats));
     }
+}
 
-    ctx->frame_x_off = gif_read_u16_le(ctx->gif_data + ctx->current_pos); gif_skip_bytes_internal(ctx, 2);
-    ctx->frame_y_off = gif_read_u16_le(ctx->gif_data + ctx->current_pos); gif_skip_bytes_internal(ctx, 2);
-    ctx->frame_width = gif_read_u16_le(ctx->gif_data + ctx->current_pos); gif_skip_bytes_internal(ctx, 2);
-    ctx->frame_height = gif_read_u16_le(ctx->gif_data + ctx->current_pos); gif_skip_bytes_internal(ctx, 2);
+int gif_format_stats(const GIF_Context *ctx, char *buffer, size_t buffer_size) {
+    if (!ctx || (!buffer && buffer_size > 0)) {
+        return GIF_ERROR_INVALID_PARAM;
+    }
+    const GIF_Stats *st = &ctx->stats;
+    // Every decoded frame ends with about one End Of Information code
+    uint64_t control = st->clear_codes + st->frames_decoded;
+    uint64_t data_codes = st->codes > control ? st->codes - control : 0;
+    double avg_string = data_codes ? (double)st->indices / (double)data_codes : 0.0;
+
+    return snprintf(buffer, buffer_size,
+                    "frames_decoded=%llu frames_reused=%llu codes=%llu clear_codes=%llu dictionary_full=%llu "
+                    "indices=%llu avg_string_len=%.2f refills=%llu bytes_moved=%llu rows_rendered=%llu "
+                    "transparent_skipped=%llu",
+                    (unsigned long long)st->frames_decoded, (unsigned long long)st->frames_reused,
+                    (unsigned long long)st->codes, (unsigned long long)st->clear_codes,
+                    (unsigned long long)st->dictionary_full, (unsigned long long)st->indices, avg_string,
+                    (unsigned long long)st->refills, (unsigned long long)st->bytes_moved,
+                    (unsigned long long)st->rows_rendered, (unsigned long long)st->transparent_skipped);
+}
+#endif
 
-    // Validate frame dimensions
-    if (ctx->frame_width == 0 || ctx->frame_height == 0) {
-        gif_report_error(ctx, GIF_ERROR_INVALID_FRAME_DIMENSIONS, "Frame has zero width or height.");
-        return -1;
+/** @brief Job queue of one gif_decode_batch() worker, alone on its cache line. */
+typedef struct {
+    /** @brief Next job to claim, advanced by the owner and by thieves. */
+    volatile uint32_t next;
+    /** @brief End of the worker's share of the jobs. */
+    uint32_t end;
+} GIF_BatchQueue;
+
+/** @brief Shared state of the workers of gif_decode_batch(). */
+typedef struct {
+    /** @brief Jobs to run. */
+    GIF_BatchJob *jobs;
+    /** @brief Number of workers. */
+    int workers;
+    /** @brief Per-worker queues, GIF_SCRATCH_ALIGN bytes apart. */
+    uint8_t *queues;
+    /** @brief Per-worker decoder scratch buffers, GIF_SCRATCH_BUFFER_REQUIRED_SIZE bytes apart. */
+    uint8_t *scratch;
+    /** @brief Clock for timings, or NULL. */
+    GIF_ClockFunc clock;
+    /** @brief User data passed to `clock`. */
+    void *user_data;
+} GIF_BatchRun;
+
+/**
+ * @brief Decodes one job of a batch.
+ * @param job Job to run; results are written back.
+ * @param scratch Decoder scratch buffer of the worker.
+ */
+static void gif_batch_run_job(GIF_BatchJob *job, uint8_t *scratch) {
+    GIF_Context ctx;
+    int delay_ms, frames = job->max_frames;
+
+    job->width = job->height = job->frames_decoded = 0;
+    job->result = gif_init(&ctx, job->data, job->size, scratch, GIF_SCRATCH_BUFFER_REQUIRED_SIZE);
+    if (job->result != GIF_SUCCESS) {
+        return;
     }
-    if (ctx->frame_x_off + ctx->frame_width > ctx->canvas_width ||
-        ctx->frame_y_off + ctx->frame_height > ctx->canvas_height)
-    {
-        gif_report_error(ctx, GIF_ERROR_INVALID_FRAME_DIMENSIONS, "Frame extends beyond canvas boundaries.");
-        return -1;
+    gif_get_info(&ctx, &job->width, &job->height);
+    if (!job->frame_buffer || job->frame_buffer_size < (size_t)job->width * job->height * 3) {
+        job->result = GIF_ERROR_BUFFER_TOO_SMALL;
+        return;
+    }
+    if (frames <= 0) {
+        // gif_next_frame() loops endlessly on looping GIFs, so count the frames of one pass
+        job->result = gif_build_frame_index(&ctx, NULL, 0, &frames);
+        if (job->result != GIF_SUCCESS) {
+            return;
+        }
+    }
+    while (job->frames_decoded < frames) {
+        int rc = gif_next_frame(&ctx, job->frame_buffer, &delay_ms);
+        if (rc == 0) {
+            break; // Fewer frames than requested
+        }
+        if (rc < 0) {
+            job->result = GIF_ERROR_DECODE;
+            return;
+        }
+        job->frames_decoded++;
     }
+}
 
-    uint8_t fisrz = gif_read_byte_internal(ctx);
-    ctx->ucGIFBits = fisrz;
+/**
+ * @brief Runs jobs from the worker's own queue, then steals from the others (GIF_TaskFunc).
+ * @param task_data Pointer to the GIF_BatchRun.
+ * @param index Worker index.
+ */
+static void gif_batch_worker(void *task_data, int index) {
+    const GIF_BatchRun *run = (const GIF_BatchRun *)task_data;
+    uint8_t *scratch = run->scratch + (size_t)index * GIF_SCRATCH_BUFFER_REQUIRED_SIZE;
+    int victim = index, misses = 0;
+
+    // Queues only move forward, so a full round of empty queues means every job is claimed
+    while (misses < run->workers) {
+        GIF_BatchQueue *queue = (GIF_BatchQueue *)(run->queues + (size_t)victim * GIF_SCRATCH_ALIGN);
+        uint32_t i = GIF_ATOMIC_FETCH_INC(&queue->next);
+        if (i >= queue->end) {
+            victim = (victim + 1) % run->workers;
+            misses++;
+            continue;
+        }
+        misses = 0;
 
-    if (fisrz & 0x80) { // Local Color Table Flag
-        int lct_size = 1 << ((fisrz & 0x07) + 1);
-        if (lct_size > GIF_MAX_COLORS) {
-            gif_report_error(ctx, GIF_ERROR_UNSUPPORTED_COLOR_DEPTH, "Local Color Table size exceeds GIF_MAX_COLORS.");
-            return -1;
+        GIF_BatchJob *job = &run->jobs[i];
+        uint64_t start = run->clock ? run->clock(run->user_data) : 0;
+        gif_batch_run_job(job, scratch);
+        job->worker = index;
+        job->elapsed = run->clock ? run->clock(run->user_data) - start : 0;
+    }
+}
+
+int gif_decode_batch(GIF_BatchJob *jobs, int count, GIF_ParallelFor parallel_for, void *user_data, int workers,
+                     uint8_t *scratch, size_t scratch_size, GIF_ClockFunc clock) {
+    GIF_BatchRun run;
+    uint8_t *aligned;
+    int i;
+
+    if (count < 0 || (count > 0 && !jobs) || workers <= 0 || !scratch || scratch_size < GIF_BATCH_SCRATCH_SIZE(workers)) {
+        return GIF_ERROR_INVALID_PARAM;
+    }
+    if (workers > count) {
+        workers = count > 0 ? count : 1;
+    }
+
+    aligned = scratch + ((GIF_SCRATCH_ALIGN - ((uintptr_t)scratch & (GIF_SCRATCH_ALIGN - 1))) & (GIF_SCRATCH_ALIGN - 1));
+    run.jobs = jobs;
+    run.workers = workers;
+    run.queues = aligned;
+    run.scratch = aligned + (size_t)workers * GIF_SCRATCH_ALIGN;
+    run.clock = clock;
+    run.user_data = user_data;
+    for (i = 0; i < workers; i++) {
+        GIF_BatchQueue *queue = (GIF_BatchQueue *)(run.queues + (size_t)i * GIF_SCRATCH_ALIGN);
+        queue->next = (uint32_t)((int64_t)count * i / workers);
+        queue->end = (uint32_t)((int64_t)count * (i + 1) / workers);
+    }
+
+    if (parallel_for && workers > 1) {
+        parallel_for(user_data, workers, gif_batch_worker, &run);
+    } else {
+        for (i = 0; i < workers; i++) {
+            gif_batch_worker(&run, i);
         }
-        if (gif_read_bytes_internal(ctx, ctx->local_palette_colors, (size_t)lct_size * 3) < (size_t)lct_size * 3) {
-            gif_report_error(ctx, GIF_ERROR_EARLY_EOF, "Early EOF while reading Local Color Table.");
-            return -1;
+    }
+    return GIF_SUCCESS;
+}
+
+int gif_player_init(GIF_Player *player, GIF_Context *ctx, uint8_t *buffers, size_t buffers_size) {
+    size_t frame_size;
+
+    if (!player || !ctx || !buffers) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid parameters for gif_player_init.");
+        return GIF_ERROR_INVALID_PARAM;
+    }
+    frame_size = (size_t)ctx->canvas_width * ctx->canvas_height * 3;
+    if (buffers_size < 2 * frame_size) {
+        gif_report_error(ctx, GIF_ERROR_BUFFER_TOO_SMALL, "Player buffers smaller than two frames.");
+        return GIF_ERROR_BUFFER_TOO_SMALL;
+    }
+    memset(buffers, 0, 2 * frame_size);
+    player->ctx = ctx;
+    player->buffers[0] = buffers;
+    player->buffers[1] = buffers + frame_size;
+    player->frame_size = frame_size;
+    player->front = 0;
+    player->ready = 0;
+    player->next_status = 0;
+    player->next_delay_ms = 0;
+    player->late = 0;
+    player->missed_deadlines = 0;
+    return GIF_SUCCESS;
+}
+
+int gif_player_prefetch(GIF_Player *player) {
+    uint8_t *back;
+
+    if (GIF_ATOMIC_LOAD_ACQUIRE(&player->ready)) {
+        return GIF_PLAYER_LATE;
+    }
+    // Frames are drawn over the previous one, so start from the frame on screen
+    back = player->buffers[player->front ^ 1];
+    memcpy(back, player->buffers[player->front], player->frame_size);
+    player->next_status = gif_next_frame(player->ctx, back, &player->next_delay_ms);
+    GIF_ATOMIC_STORE_RELEASE(&player->ready, 1u); // Publishes the back buffer
+    return player->next_status;
+}
+
+int gif_player_present(GIF_Player *player, uint8_t **frame, int *delay_ms) {
+    int status;
+
+    if (!GIF_ATOMIC_LOAD_ACQUIRE(&player->ready)) {
+        if (!player->late) {
+            player->late = 1;
+            player->missed_deadlines++;
         }
-        ctx->active_palette_colors = ctx->local_palette_colors;
+        return GIF_PLAYER_LATE;
+    }
+    status = player->next_status;
+    if (status == 1) {
+        player->front ^= 1;
+        *delay_ms = player->next_delay_ms;
+    }
+    *frame = player->buffers[player->front];
+    player->late = 0;
+    GIF_ATOMIC_STORE_RELEASE(&player->ready, 0u); // Hands the back buffer to the next prefetch
+    return status;
+}
+
+#ifdef GIF_MODE_TURBO
+int gif_set_index_canvas(GIF_Context *ctx, uint8_t *index_canvas, size_t index_canvas_size) {
+    if (!ctx || (index_canvas && index_canvas_size == 0)) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid parameters for gif_set_index_canvas.");
+        return GIF_ERROR_INVALID_PARAM;
+    }
+    ctx->index_canvas = index_canvas;
+    ctx->index_canvas_size = index_canvas ? index_canvas_size : 0;
+    return GIF_SUCCESS;
+}
+
+int gif_set_frame_cache(GIF_Context *ctx, uint8_t *memory, size_t memory_size) {
+    if (!ctx || (memory && memory_size < sizeof(GIF_FrameCacheEntry) + GIF_SCRATCH_ALIGN)) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid parameters for gif_set_frame_cache.");
+        return GIF_ERROR_INVALID_PARAM;
+    }
+    ctx->frame_cache = memory;
+    // Align the end of the frame table so every entry is naturally aligned
+    ctx->frame_cache_size = memory ? memory_size - (((uintptr_t)memory + memory_size) & (GIF_SCRATCH_ALIGN - 1)) : 0;
+    ctx->frame_cache_used = 0;
+    ctx->frame_cache_frames = 0;
+    return GIF_SUCCESS;
+}
+
+int gif_set_parallel_decode(GIF_Context *ctx, GIF_ParallelFor parallel_for, void *user_data, int workers,
+                            uint8_t *parallel_scratch, size_t parallel_scratch_size) {
+    uint8_t *aligned;
+
+    if (!ctx || workers < 0 || (workers > 0 && (!parallel_scratch || parallel_scratch_size < GIF_PARALLEL_SCRATCH_SIZE(workers, 0)))) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid parameters for gif_set_parallel_decode.");
+        return GIF_ERROR_INVALID_PARAM;
+    }
+    ctx->parallel_for = parallel_for;
+    ctx->parallel_user_data = user_data;
+    ctx->parallel_workers = workers;
+    if (workers == 0) {
+        ctx->parallel_dicts = NULL;
+        ctx->parallel_segments = NULL;
+        ctx->parallel_stream = NULL;
+        ctx->parallel_stream_capacity = 0;
+        return GIF_SUCCESS;
+    }
+
+    aligned = parallel_scratch + ((GIF_SCRATCH_ALIGN - ((uintptr_t)parallel_scratch & (GIF_SCRATCH_ALIGN - 1))) & (GIF_SCRATCH_ALIGN - 1));
+    ctx->parallel_dicts = (GIF_LZWEntry *)aligned;
+    aligned += (size_t)workers * GIF_SCRATCH_ALIGN_UP(GIF_SCRATCH_LZW_DICT_SIZE);
+    ctx->parallel_segments = (GIF_LZWSegment *)aligned;
+    aligned += GIF_SCRATCH_ALIGN_UP(GIF_PARALLEL_MAX_SEGMENTS * sizeof(GIF_LZWSegment));
+    ctx->parallel_stream = aligned;
+    ctx->parallel_stream_capacity = parallel_scratch_size - (size_t)(aligned - parallel_scratch);
+    if (ctx->parallel_stream_capacity > 0x7FFFFFFF) { // LZW read offsets are ints
+        ctx->parallel_stream_capacity = 0x7FFFFFFF;
+    }
+    return GIF_SUCCESS;
+}
+
+int gif_decode_frame_planes(GIF_Context *ctx, GIF_FramePlane *planes, int count, GIF_ParallelFor parallel_for,
+                            void *user_data, int workers, uint8_t *worker_scratch, size_t worker_scratch_size) {
+    GIF_PlaneJob job;
+    int i;
+
+    if (!ctx || count < 0 || (count > 0 && !planes) || workers <= 0 || !worker_scratch ||
+        worker_scratch_size < (size_t)workers * GIF_WORKER_SCRATCH_SIZE) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid parameters for gif_decode_frame_planes.");
+        return GIF_ERROR_INVALID_PARAM;
+    }
+    for (i = 0; i < count; i++) {
+        if (!planes[i].frame || !planes[i].indices) {
+            gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid frame plane for gif_decode_frame_planes.");
+            return GIF_ERROR_INVALID_PARAM;
+        }
+    }
+
+    job.ctx = ctx;
+    job.planes = planes;
+    job.count = count;
+    job.workers = workers < count ? workers : count;
+    job.worker_scratch = worker_scratch;
+    if (parallel_for && job.workers > 1) {
+        parallel_for(user_data, job.workers, gif_decode_planes_task, &job);
     } else {
-        ctx->active_palette_colors = ctx->global_palette_colors;
+        for (i = 0; i < job.workers; i++) {
+            gif_decode_planes_task(&job, i);
+        }
     }
+    return GIF_SUCCESS;
+}
 
-    ctx->lzw_code_start_size = gif_read_byte_internal(ctx);
+int gif_composite_frame(GIF_Context *ctx, const GIF_FramePlane *plane, uint8_t *frame_buffer, int *delay_ms) {
+    const GIF_FrameInfo *frame;
 
-    int decode_result = gif_decode_lzw(ctx, frame_buffer);
-    if (decode_result != GIF_SUCCESS) {
-        gif_report_error(ctx, decode_result, "LZW decoding failed for frame.");
+    if (!ctx || !plane || !plane->frame || !frame_buffer || !delay_ms) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid parameters for gif_composite_frame.");
+        return -1;
+    }
+    frame = plane->frame;
+    if (plane->result != GIF_SUCCESS) {
+        gif_report_error(ctx, plane->result, "LZW decoding failed for frame.");
         return -1;
     }
 
+    ctx->frame_x_off = frame->x_off;
+    ctx->frame_y_off = frame->y_off;
+    ctx->frame_width = frame->width;
+    ctx->frame_height = frame->height;
+    ctx->frame_delay_ms = frame->delay_ms;
+    ctx->ucGIFBits = frame->ucGIFBits;
+    ctx->has_transparency = frame->has_transparency;
+    ctx->transparent_index = frame->transparent_index;
+    ctx->disposal_method = frame->disposal_method;
+    if (frame->local_palette_size) {
+        memcpy(ctx->local_palette_colors, ctx->gif_data + frame->local_palette_pos, (size_t)frame->local_palette_size * 3);
+        ctx->active_palette_colors = ctx->local_palette_colors;
+    } else {
+        ctx->active_palette_colors = ctx->global_palette_colors;
+    }
+
+    gif_render_plane(ctx, frame_buffer, plane->indices, plane->decoded);
     *delay_ms = ctx->frame_delay_ms;
     return 1;
 }
 
-void gif_rewind(GIF_Context *ctx) {
-    if (ctx) {
-        ctx->current_pos = ctx->anim_start_pos;
+int gif_next_frame_plane(GIF_Context *ctx, GIF_FrameInfo *frame, GIF_FramePlane *plane) {
+    GIF_LZWPlane out;
+    uint32_t ulBits;
+    int result;
+
+    if (!ctx || !frame || !plane || !plane->indices) {
+        gif_report_error(ctx, GIF_ERROR_INVALID_PARAM, "Invalid parameters for gif_next_frame_plane.");
+        return -1;
+    }
+
+    int image = gif_next_image(ctx);
+    if (image != 1) {
+        return image;
+    }
+
+    gif_capture_frame_info(ctx, frame);
+    ctx->last_frame_end = 0; // The frame is not rendered into the caller's frame buffer
+    plane->frame = frame;
+    plane->decoded = 0;
+    if ((size_t)ctx->frame_width * ctx->frame_height > plane->indices_size) {
         ctx->lzw_end_of_frame = 0;
-        ctx->lzw_read_offset = 0;
-        ctx->lzw_data_size = 0;
+        result = GIF_ERROR_BUFFER_TOO_SMALL;
+    } else {
+        result = gif_lzw_begin_frame(ctx, &ulBits);
+        if (result == GIF_SUCCESS) {
+            out.out = plane->indices;
+            out.out_pos = 0;
+            out.out_size = ctx->frame_width * ctx->frame_height;
+            out.out_capacity = plane->indices_size;
+            out.bitnum = 0;
+            result = gif_lzw_decode_segment(ctx, &out, ulBits);
+            plane->decoded = out.out_pos;
+        }
+    }
+    if (!ctx->lzw_end_of_frame) {
+        gif_discard_sub_blocks(ctx); // Skip sub-blocks left after the End Of Information code
+    }
+    plane->result = result;
+    if (result != GIF_SUCCESS) {
+        gif_report_error(ctx, result, "LZW decoding failed for frame.");
+        return -1;
+    }
+    return 1;
+}
+
+int gif_pipeline_init(GIF_Pipeline *pipe, int slots, size_t plane_size, uint8_t *memory, size_t memory_size) {
+    uint8_t *aligned;
+    int i;
+
+    if (!pipe || slots <= 0 || plane_size == 0 || !memory || memory_size < GIF_PIPELINE_MEMORY_SIZE(slots, plane_size)) {
+        return GIF_ERROR_INVALID_PARAM;
+    }
+    aligned = memory + ((GIF_SCRATCH_ALIGN - ((uintptr_t)memory & (GIF_SCRATCH_ALIGN - 1))) & (GIF_SCRATCH_ALIGN - 1));
+    pipe->slots = (GIF_PipelineSlot *)aligned;
+    pipe->slot_count = (uint32_t)slots;
+    aligned += GIF_SCRATCH_ALIGN_UP((size_t)slots * sizeof(GIF_PipelineSlot));
+    for (i = 0; i < slots; i++) {
+        memset(&pipe->slots[i], 0, sizeof(GIF_PipelineSlot));
+        pipe->slots[i].plane.indices = aligned;
+        pipe->slots[i].plane.indices_size = plane_size;
+        aligned += GIF_SCRATCH_ALIGN_UP(plane_size);
     }
+    pipe->head = 0;
+    pipe->tail = 0;
+    return GIF_SUCCESS;
 }
 
-void gif_close(GIF_Context *ctx) {
-    if (ctx) {
-        memset(ctx, 0, sizeof(GIF_Context));
+int gif_pipeline_push(GIF_Pipeline *pipe, GIF_Context *ctx) {
+    uint32_t head = pipe->head; // Only this stage writes `head`
+    GIF_PipelineSlot *slot;
+
+    if (head - GIF_ATOMIC_LOAD_ACQUIRE(&pipe->tail) >= pipe->slot_count) {
+        return GIF_PIPELINE_BUSY;
     }
+    slot = &pipe->slots[head % pipe->slot_count];
+    slot->status = gif_next_frame_plane(ctx, &slot->frame, &slot->plane);
+    GIF_ATOMIC_STORE_RELEASE(&pipe->head, head + 1); // Publishes the slot contents
+    return slot->status;
 }
 
-void gif_set_error_callback(GIF_Context *ctx, GIF_ErrorCallback callback) {
-    if (ctx) {
-        ctx->error_callback = callback;
+int gif_pipeline_pop(GIF_Pipeline *pipe, GIF_Context *ctx, uint8_t *frame_buffer, int *delay_ms) {
+    uint32_t tail = pipe->tail; // Only this stage writes `tail`
+    GIF_PipelineSlot *slot;
+    int result;
+
+    if (GIF_ATOMIC_LOAD_ACQUIRE(&pipe->head) == tail) {
+        return GIF_PIPELINE_BUSY;
     }
+    slot = &pipe->slots[tail % pipe->slot_count];
+    result = (slot->status == 1) ? gif_composite_frame(ctx, &slot->plane, frame_buffer, delay_ms) : slot->status;
+    GIF_ATOMIC_STORE_RELEASE(&pipe->tail, tail + 1); // Hands the slot back to the producer
+    return result;
 }
+#endif
 
 #endif // GIF_IMPLEMENTATION
 